@@ -53,6 +53,7 @@ class Proof {
 public:
     Proof();                        // Offline mode -- proof stored to a file, which can be saved, compressed, and/or traversed.
     Proof(ProofTraverser& t);       // Online mode -- proof will not be stored.
+   ~Proof();                        // Removes the temporary file of an offline proof.
 
     ClauseId addRoot   (vec<Lit>& clause);
     void     beginChain(ClauseId start);
@@ -61,7 +62,7 @@ public:
     void     deleted   (ClauseId gone);
     ClauseId last      () { assert(id_counter != ClauseId_NULL); return id_counter - 1; }
 
-    void     compress  (Proof& dst, ClauseId goal = ClauseId_NULL);     // 'dst' should be a newly constructed, empty proof.
+    void     compress  (Proof& dst, ClauseId goal = ClauseId_NULL, vec<ClauseId>* ids = NULL);     // 'dst' should be a newly constructed, empty proof. 'ids' receives the original ID of every clause in 'dst'.
     bool     save      (cchar* filename);
     void     traverse  (ProofTraverser& trav, ClauseId goal = ClauseId_NULL) ;
 };
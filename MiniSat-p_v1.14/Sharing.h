@@ -0,0 +1,76 @@
+/***************************************************************************************[Sharing.h]
+MiniSat -- Copyright (c) 2003-2005, Niklas Een, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Sharing_h
+#define Sharing_h
+
+#include "SolverTypes.h"
+
+#include <mutex>
+#include <vector>
+
+
+//=================================================================================================
+// SharedClauses -- learnt clauses exchanged between solvers working on the same problem:
+
+
+// Every solver publishes into its own shard, so publishing only contends with the solvers that are
+// reading that shard at the same moment. A shard keeps the last 'capacity' clauses; a solver that
+// falls further behind misses the older ones (sharing is a heuristic, nothing depends on it).
+//
+// All solvers must have the same problem clauses (and eliminate the same variables, if they are
+// 'SimpSolver's). No proofs are logged for imported clauses. A solver imports at decision level 0
+// only, i.e. not while it solves under assumptions (it still publishes its clauses then).
+//
+class SharedClauses {
+    struct Entry {
+        std::vector<Lit>    lits;
+        int                 lbd;
+    };
+
+    struct Shard {
+        std::mutex          lock;
+        std::vector<Entry>  ring;             // 'ring[n % capacity]' is the n-th clause published.
+        int64               published;        // Number of clauses published so far.
+        Shard() : published(0) { }
+    };
+
+    int                     capacity;
+    std::vector<Shard>      shards;
+    std::vector<int64>      read;             // 'read[to * shards.size() + from]' is the number of clauses of 'from' collected by 'to'.
+
+public:
+    SharedClauses(int solvers, int capacity = 4096);
+
+    // Mode of operation:
+    //
+    int     max_size;           // Clauses up to this size are shared ...
+    int     max_lbd;            // ... as well as clauses with at most this LBD.
+
+    // Publishes a clause learnt by solver 'from' (if it is short enough).
+    void    publish(int from, const vec<Lit>& c, int lbd);
+
+    // Appends the clauses published by the other solvers since the last call by solver 'to' to
+    // 'out' and their LBDs to 'lbds'. Must only be called by solver 'to' itself.
+    void    collect(int to, vec<vec<Lit> >& out, vec<int>& lbds);
+};
+
+
+//=================================================================================================
+#endif
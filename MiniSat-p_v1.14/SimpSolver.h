@@ -0,0 +1,100 @@
+/************************************************************************************[SimpSolver.h]
+MiniSat -- Copyright (c) 2003-2005, Niklas Een, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef SimpSolver_h
+#define SimpSolver_h
+
+#include "Solver.h"
+
+
+//=================================================================================================
+// SimpSolver -- a Solver that preprocesses its problem clauses (as in SatELite):
+
+
+// Before the first search, the problem clauses are simplified by subsumption, self-subsuming
+// resolution and bounded variable elimination. A variable is eliminated by replacing the clauses
+// it occurs in by all their non-tautological resolvents on it, if that does not increase the number
+// of clauses. Models are extended to the eliminated variables after a successful 'solve()'.
+//
+// Eliminated variables must not occur in clauses or assumptions given to the solver later. Every
+// variable that is needed after the first 'solve()' (e.g. for incremental use, or to be read from
+// the model before it is extended) must therefore be frozen with 'setFrozen()'. The assumptions of
+// the first 'solve()' are frozen automatically. No preprocessing is done in proof logging mode.
+//
+class SimpSolver : public Solver {
+protected:
+    vec<char>           frozen;           // 'frozen[var]' is TRUE if 'var' must not be eliminated.
+    vec<char>           eliminated;       // 'eliminated[var]' is TRUE if 'var' has been eliminated.
+    vec<int>            elimclauses;      // Removed clauses needed to extend models: literals (the eliminated one first) followed by the size.
+    bool                elim_done;        // Preprocessing takes place at most once.
+
+    // Clauses during preprocessing:
+    //
+    vec<vec<Lit> >      cls;              // The problem clauses ...
+    vec<uint>           cls_abst;         // ... their abstractions (a bit for every variable modulo 32) ...
+    vec<char>           cls_dead;         // ... and whether they have been removed.
+    vec<vec<int> >      occs;             // 'occs[var]' are the indices of the clauses containing 'var' (may include removed ones).
+    vec<int>            subsumption_queue;// Clauses to check for (self-)subsumption of other clauses.
+    int                 elim_qhead;       // Head of the queue of top-level assignments (into 'trail[]') not yet applied to 'cls'.
+    vec<char>           elim_seen;        // Temporary for 'merge()', indexed by literals.
+
+    void        addPreClause     (const vec<Lit>& ps);
+    void        killPreClause    (int ci);
+    bool        strengthen       (int ci, Lit p);
+    bool        propagateUnits   ();
+    bool        backwardSubsumption();
+    bool        merge            (const vec<Lit>& ps, const vec<Lit>& qs, Var v, vec<Lit>& out);
+    bool        eliminateVar     (Var v);
+    void        extendModel      ();
+
+public:
+    SimpSolver() : elim_done      (false)
+                 , elim_qhead     (0)
+                 , use_elim       (true)
+                 , clause_lim     (20)
+                 , subsumption_lim(1000)
+                 , eliminated_vars(0)
+                 { }
+
+    // Mode of operation:
+    //
+    bool    use_elim;           // Preprocess before the first search. TRUE by default.
+    int     clause_lim;         // Variables are not eliminated if that produces a resolvent longer than this.
+    int     subsumption_lim;    // Occurrence lists longer than this are not checked for subsumed clauses.
+
+    // Statistics: (read-only member variables)
+    //
+    int     eliminated_vars;
+
+    // Problem specification:
+    //
+    void    setFrozen   (Var v, bool b) { frozen.growTo(nVars(), 0); frozen[v] = (char)b; }
+    bool    isEliminated(Var v) const   { return v < eliminated.size() && eliminated[v]; }
+
+    // Solving:
+    //
+    bool    eliminate();
+    bool    solve(const vec<Lit>& assumps) { budgetOff(); return solveLimited(assumps) == l_True; }
+    bool    solve() { vec<Lit> tmp; return solve(tmp); }
+    lbool   solveLimited(const vec<Lit>& assumps);
+};
+
+
+//=================================================================================================
+#endif
@@ -24,9 +24,14 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "VarOrder.h"
 #include "Proof.h"
 
+#include <atomic>
+#include <chrono>
+
 // Redfine if you want output to go somewhere else:
 #define reportf(format, args...) ( printf(format , ## args), fflush(stdout) )
 
+class SharedClauses;    // (see 'Sharing.h')
+
 
 //=================================================================================================
 // Solver -- the main class:
@@ -35,14 +40,33 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 struct SolverStats {
     int64   starts, decisions, propagations, conflicts;
     int64   clauses_literals, learnts_literals, max_literals, tot_literals;
+    int64   imported;       // Clauses imported from other solvers (see 'Solver::sharing') or by 'Solver::addLearnts()'.
+    int64   imported_used;  // Imported clauses (not units) that were used in conflict analysis at least once.
     SolverStats() : starts(0), decisions(0), propagations(0), conflicts(0)
-      , clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0) { }
+      , clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0), imported(0), imported_used(0) { }
 };
 
 
+// Restart strategies: geometrically growing conflict limits (100, 150, 225, ...), the Luby sequence
+// times 'luby_unit' conflicts, or dynamic restarts when the LBD of recently learnt clauses is high
+// compared to the average so far (as in Glucose).
+enum RestartPolicy { restart_Geometric, restart_Luby, restart_Glucose };
+
 struct SearchParams {
-    double  var_decay, clause_decay, random_var_freq;    // (reasonable values are: 0.95, 0.999, 0.02)    
-    SearchParams(double v = 1, double c = 1, double r = 0) : var_decay(v), clause_decay(c), random_var_freq(r) { }
+    double          var_decay, clause_decay, random_var_freq;   // (reasonable values are: 0.95, 0.999, 0.02)
+    RestartPolicy   restarts;
+    bool            phase_saving;       // Branch on the value a variable had last instead of always 'false'.
+    int             luby_unit;          // Conflicts per unit of the Luby sequence (reasonable value: 100).
+    double          glucose_k;          // Restart if 'glucose_k' * recent average LBD > total average LBD (reasonable value: 0.8).
+    int             glucose_window;     // Number of recent conflicts whose LBDs are averaged (reasonable value: 50).
+    int             reduce_first;       // Conflicts before the first reduction of the learnt clauses (reasonable value: 2000) ...
+    int             reduce_inc;         // ... growing by 'reduce_inc' conflicts with every reduction (reasonable value: 300).
+    int             core_lbd;           // Learnt clauses with at most this LBD are kept forever (reasonable value: 2) ...
+    int             tier2_lbd;          // ... up to this LBD as long as they are used between reductions (reasonable value: 6).
+    SearchParams(double v = 1, double c = 1, double r = 0, RestartPolicy rs = restart_Geometric, bool ps = false)
+        : var_decay(v), clause_decay(c), random_var_freq(r), restarts(rs), phase_saving(ps)
+        , luby_unit(100), glucose_k(0.8), glucose_window(50)
+        , reduce_first(2000), reduce_inc(300), core_lbd(2), tier2_lbd(6) { }
 };
 
 
@@ -51,8 +75,9 @@ protected:
     // Solver state:
     //
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
-    vec<Clause*>        clauses;          // List of problem clauses.
-    vec<Clause*>        learnts;          // List of learnt clauses.
+    ClauseAllocator     ca;               // Arena holding all clauses.
+    vec<CRef>           clauses;          // List of problem clauses.
+    vec<CRef>           learnts;          // List of learnt clauses.
     vec<ClauseId>       unit_id;          // 'unit_id[var]' is the clause ID for the unit literal 'var' or '~var' (if set at toplevel).
     double              cla_inc;          // Amount to bump next clause with.
     double              cla_decay;        // INVERSE decay factor for clause activity: stores 1/decay.
@@ -62,25 +87,45 @@ protected:
     double              var_decay;        // INVERSE decay factor for variable activity: stores 1/decay. Use negative value for static variable order.
     VarOrder            order;            // Keeps track of the decision variable order.
 
-    vec<vec<Clause*> >  watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    vec<WatchLists>     watches;          // 'watches[lit]' are the lists of constraints watching 'lit' (will go there if literal becomes true).
     vec<char>           assigns;          // The current assignments (lbool:s stored as char:s).
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail[]'.
-    vec<Clause*>        reason;           // 'reason[var]' is the clause that implied the variables current value, or 'NULL' if none.
+    vec<CRef>           reason;           // 'reason[var]' is the clause that implied the variables current value, or 'CRef_Undef' if none.
     vec<int>            level;            // 'level[var]' is the decision level at which assignment was made.
     vec<int>            trail_pos;        // 'trail_pos[var]' is the variable's position in 'trail[]'. This supersedes 'level[]' in some sense, and 'level[]' will probably be removed in future releases.
+    vec<char>           decision;         // 'decision[var]' is FALSE if 'var' must not be branched on (see 'setDecisionVar()').
+    vec<char>           polarity;         // 'polarity[var]' is the sign of the last value of 'var' (for phase saving). Initially 'false' (negative).
     int                 root_level;       // Level of first proper decision.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplifyDB()'.
     int64               simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplifyDB()'.
+    int64               conflict_budget;  // -1 means no budget.
+    int64               propagation_budget;
+    bool                time_budget_on;
+    bool                time_out;         // Set when 'time_deadline' has passed (the clock is only polled now and then).
+    std::chrono::steady_clock::time_point time_deadline;
+    uint                budget_polls;
+    std::atomic<bool>   asynch_interrupt;
+    int64               reduce_last;      // Number of conflicts at the last execution of 'reduceDB()'.
+    int                 reduce_count;     // Number of executions of 'reduceDB()' so far.
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which is used:
     //
     vec<char>           analyze_seen;
     vec<Lit>            analyze_stack;
     vec<Lit>            analyze_toclear;
-    Clause*             propagate_tmpbin;
-    Clause*             analyze_tmpbin;
+    vec<uint>           lbd_stamp;        // 'lbd_stamp[level]' is 'lbd_counter' if 'level' was already counted.
+    uint                lbd_counter;
+    vec<int>            lbd_recent;       // LBDs of the last 'glucose_window' conflicts (ring buffer) ...
+    int                 lbd_recent_head;
+    int64               lbd_recent_sum;
+    int64               lbd_total_sum;    // ... and the sum of the LBDs of all conflicts so far.
+    int64               lbd_total_count;
+    vec<vec<Lit> >      import_clauses;
+    vec<int>            import_lbds;
+    vec<Lit>            newClause_tmp;
+    vec<Lit>            addClauses_tmp;
     vec<Lit>            addUnit_tmp;
     vec<Lit>            addBinary_tmp;
     vec<Lit>            addTernary_tmp;
@@ -91,14 +136,25 @@ protected:
     void        cancelUntil      (int level);
     void        record           (const vec<Lit>& clause);
 
-    void        analyze          (Clause* confl, vec<Lit>& out_learnt, int& out_btlevel); // (bt = backtrack)
+    void        analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
     bool        analyze_removable(Lit p, uint min_level);                                 // (helper method for 'analyze()')
-    void        analyzeFinal     (Clause* confl, bool skip_first = false);
-    bool        enqueue          (Lit fact, Clause* from = NULL);
-    Clause*     propagate        ();
-    void        reduceDB         ();
+    void        analyzeFinal     (CRef confl, bool skip_first = false);
+    bool        enqueue          (Lit fact, CRef from = CRef_Undef);
+    CRef        propagate        ();
+    void        proofUnit        (const Clause& c);
+    bool        reduceDue        (const SearchParams& params) const;
+    void        reduceDB         (const SearchParams& params);
+    void        checkGarbage     ();
+    void        garbageCollect   ();
+    void        relocAll         (ClauseAllocator& to);
     Lit         pickBranchLit    (const SearchParams& params);
-    lbool       search           (int nof_conflicts, int nof_learnts, const SearchParams& params);
+    template<class Lits>
+    int         computeLBD       (const Lits& lits);
+    bool        glucoseRestart   (const SearchParams& params) const;
+    bool        withinBudget     ();
+    bool        importShared     ();
+    bool        importClauses    (vec<vec<Lit> >& cs, const vec<int>& lbds);
+    lbool       search           (int nof_conflicts, const SearchParams& params);
     double      progressEstimate ();
 
     // Activity:
@@ -115,10 +171,19 @@ protected:
     // Operations on clauses:
     //
     void     newClause(const vec<Lit>& ps, bool learnt = false, ClauseId id = ClauseId_NULL);
-    void     claBumpActivity (Clause* c) { if ( (c->activity() += cla_inc) > 1e20 ) claRescaleActivity(); }
-    void     remove          (Clause* c, bool just_dealloc = false);
-    bool     locked          (const Clause* c) const { return reason[var((*c)[0])] == c; }
-    bool     simplify        (Clause* c) const;
+    void     claBumpActivity (Clause& c) { if ( (c.activity() += cla_inc) > 1e20 ) claRescaleActivity(); }
+    void     remove          (CRef cr);
+    bool     locked          (CRef cr) const {
+        const Clause& c = ca[cr];
+        return reason[var(c[0])] == cr || (c.size() == 2 && reason[var(c[1])] == cr); }
+
+    // Returns the reason clause of 'x' with the implied literal first. Binary clauses are
+    // propagated without reordering their literals, so this is done when they are analyzed.
+    Clause&  reasonOf        (Var x) {
+        Clause& c = ca[reason[x]];
+        if (var(c[0]) != x){ Lit t = c[0]; c[0] = c[1]; c[1] = t; }
+        return c; }
+    bool     simplify        (CRef cr) const;
 
     int      decisionLevel() const { return trail_lim.size(); }
 
@@ -128,32 +193,39 @@ public:
              , cla_decay        (1)
              , var_inc          (1)
              , var_decay        (1)
-             , order            (assigns, activity)
+             , order            (assigns, decision, activity)
              , qhead            (0)
              , simpDB_assigns   (0)
              , simpDB_props     (0)
+             , conflict_budget  (-1)
+             , propagation_budget(-1)
+             , time_budget_on   (false)
+             , time_out         (false)
+             , budget_polls     (0)
+             , asynch_interrupt (false)
+             , reduce_last      (0)
+             , reduce_count     (0)
+             , lbd_counter      (0)
+             , lbd_recent_head  (0)
+             , lbd_recent_sum   (0)
+             , lbd_total_sum    (0)
+             , lbd_total_count  (0)
              , default_params   (SearchParams(0.95, 0.999, 0.02))
              , expensive_ccmin  (true)
              , proof            (NULL)
              , verbosity        (0)
+             , sharing          (NULL)
+             , sharing_id       (0)
+             , garbage_frac     (0.20)
              , progress_estimate(0)
+             , interrupt_flag   (&asynch_interrupt)
              , conflict_id      (ClauseId_NULL)
              {
-                vec<Lit> dummy(2,lit_Undef);
-                propagate_tmpbin = Clause_new(false, dummy);
-                analyze_tmpbin   = Clause_new(false, dummy);
                 addUnit_tmp   .growTo(1);
                 addBinary_tmp .growTo(2);
                 addTernary_tmp.growTo(3);
              }
 
-   ~Solver() {
-       for (int i = 0; i < learnts.size(); i++) remove(learnts[i], true);
-       for (int i = 0; i < clauses.size(); i++) if (clauses[i] != NULL) remove(clauses[i], true);
-       remove(propagate_tmpbin, true);
-       remove(analyze_tmpbin, true);
-    }
-
     // Helpers: (semi-internal)
     //
     lbool   value(Var x) const { return toLbool(assigns[x]); }
@@ -173,6 +245,9 @@ public:
     bool            expensive_ccmin;    // Controls conflict clause minimization. TRUE by default.
     Proof*          proof;              // Set this directly after constructing 'Solver' to enable proof logging. Initialized to NULL.
     int             verbosity;          // Verbosity level. 0=silent, 1=some progress report, 2=everything
+    SharedClauses*  sharing;            // Set to exchange short learnt clauses with other solvers (not in proof logging mode). Initialized to NULL.
+    int             sharing_id;         // The index of this solver in 'sharing'.
+    double          garbage_frac;       // The clause arena is compacted when this fraction of it is wasted by removed clauses.
 
     // Problem specification:
     //
@@ -182,17 +257,41 @@ public:
     void    addBinary (Lit p, Lit q)        { addBinary_tmp [0] = p; addBinary_tmp [1] = q; addClause(addBinary_tmp); }
     void    addTernary(Lit p, Lit q, Lit r) { addTernary_tmp[0] = p; addTernary_tmp[1] = q; addTernary_tmp[2] = r; addClause(addTernary_tmp); }
     void    addClause (const vec<Lit>& ps)  { newClause(ps); }  // (used to be a difference between internal and external method...)
+    void    addClauses(const vec<Lit>& lits, const vec<int>& sizes);   // Adds clauses stored one after another ('sizes[i]' literals each).
+    void    setDecisionVar(Var x, bool b)   { decision[x] = (char)b; if (b) order.undo(x); }
+    void    setRandomSeed (double seed)     { order.seed(seed); }   // (for diversifying solvers working on the same problem)
+    bool    addLearnts    (vec<vec<Lit> >& cs, const vec<int>& lbds) { return importClauses(cs, lbds); }    // Adds clauses implied by the problem as learnt clauses ('cs' is modified).
+    void    learntClauses (int max_size, vec<vec<Lit> >& out, vec<int>& lbds);  // Appends the top-level units and the learnt clauses up to 'max_size' literals.
 
     // Solving:
     //
     bool    okay() { return ok; }       // FALSE means solver is in an conflicting state (must never be used again!)
     void    simplifyDB();
-    bool    solve(const vec<Lit>& assumps);
+    bool    solve(const vec<Lit>& assumps) { budgetOff(); return solveLimited(assumps) == l_True; }
     bool    solve() { vec<Lit> tmp; return solve(tmp); }
+    lbool   solveLimited(const vec<Lit>& assumps);  // 'l_Undef' if a budget ran out or the solver was interrupted.
+    int     lookahead(const vec<Lit>& cube, Lit p);  // Variables assigned by propagating 'cube' and 'p' (-1 on a conflict).
+
+    // Resource constraints: (budgets count from the moment they are set; 'solve()' turns them off)
+    //
+    void    setConfBudget (int64 x)     { conflict_budget    = stats.conflicts    + x; }
+    void    setPropBudget (int64 x)     { propagation_budget = stats.propagations + x; }
+    void    setTimeBudget (double secs) {
+        time_budget_on = true;
+        time_out       = false;
+        time_deadline  = std::chrono::steady_clock::now()
+                       + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(secs)); }
+    void    budgetOff     ()            { conflict_budget = propagation_budget = -1; time_budget_on = time_out = false; }
+
+    // Interrupts a running 'solve()' or 'solveLimited()' (may be called from another thread or a
+    // signal handler). The flag stays set until it is cleared; while it is, 'solve()' fails at once.
+    void    interrupt     ()            { interrupt_flag->store(true, std::memory_order_relaxed); }
+    void    clearInterrupt()            { interrupt_flag->store(false, std::memory_order_relaxed); }
 
     double      progress_estimate;  // Set by 'search()'.
     vec<lbool>  model;              // If problem is satisfiable, this vector contains the model (if any).
     vec<Lit>    conflict;           // If problem is unsatisfiable under assumptions, this vector represent the conflict clause expressed in the assumptions.
+    std::atomic<bool>* interrupt_flag;  // Polled by 'search()'. Point it to a flag shared with other solvers to interrupt them together.
     ClauseId    conflict_id;        // (In proof logging mode only.) ID for the clause 'conflict' (for proof traverseral). NOTE! The empty clause is always the last clause derived, but for conflicts under assumption, this is not necessarly true.
 };
 
@@ -82,33 +82,150 @@ const   int ClauseId_NULL = INT_MIN;
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 class Clause {
-    uint    size_learnt;
+    uint    header;     // size << 11 | imported << 10 | lbd << 4 | used << 3 | reloced << 2 | has_id << 1 | learnt
     Lit     data[1];
 public:
+    enum { lbd_max = 63 };  // (larger LBDs are stored as 'lbd_max')
+
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     Clause(bool learnt, const vec<Lit>& ps, ClauseId id_ = ClauseId_NULL) {
-        size_learnt = (ps.size() << 1) | (int)learnt;
+        assert(ps.size() < (1 << 21));
+        header = (ps.size() << 11) | ((int)(id_ != ClauseId_NULL) << 1) | (int)learnt;
         for (int i = 0; i < ps.size(); i++) data[i] = ps[i];
         if (learnt) activity() = 0;
         if (id_ != ClauseId_NULL) id() = id_; }
 
-    // -- use this function instead:
-    friend Clause* Clause_new(bool, const vec<Lit>&, ClauseId);
-
-    int       size        ()      const { return size_learnt >> 1; }
-    bool      learnt      ()      const { return size_learnt & 1; }
+    // -- use 'ClauseAllocator::alloc()' instead.
+    static int words(int size, bool learnt, bool has_id) {
+        return 1 + size + (int)learnt + (int)has_id; }
+
+    int       size        ()      const { return header >> 11; }
+    bool      learnt      ()      const { return header & 1; }
+    bool      hasId       ()      const { return header & 2; }
+    bool      reloced     ()      const { return header & 4; }
+
+    // Learnt clauses only: the literal block distance (the number of decision levels among the
+    // literals) and whether the clause was used in conflict analysis since the last 'reduceDB()'.
+    int       lbd         ()      const { return (header >> 4) & lbd_max; }
+    void      lbd         (int l)       { header = (header & ~(lbd_max << 4)) | (min(l, (int)lbd_max) << 4); }
+    bool      used        ()      const { return header & 8; }
+    void      used        (bool b)      { header = b ? header | 8 : header & ~8; }
+
+    // Learnt clauses only: whether the clause was imported (see 'Solver::addLearnts()') and not
+    // used in conflict analysis yet.
+    bool      imported    ()      const { return header & 1024; }
+    void      imported    (bool b)      { header = b ? header | 1024 : header & ~1024; }
     Lit       operator [] (int i) const { return data[i]; }
     Lit&      operator [] (int i)       { return data[i]; }
     float&    activity    ()      const { return *((float*)&data[size()]); }
     ClauseId& id          ()      const { return *((ClauseId*)&data[size() + (int)learnt()]); }
+
+    // After compaction, a moved clause forwards to its new location:
+    uint      relocation  ()      const { return data[0].hash(); }
+    void      relocate    (uint to)     { header |= 4; data[0] = toLit(to); }
+};
+
+
+//=================================================================================================
+// ClauseAllocator -- clauses stored contiguously in one arena:
+
+
+// A reference to a clause is its offset (in 32-bit words) into the arena. Clause references stay
+// valid while clauses are allocated, 'Clause&' and 'Clause*' obtained from them do not.
+typedef uint CRef;
+const   CRef CRef_Undef = UINT_MAX;
+
+class ClauseAllocator {
+    uint*   memory;
+    uint    sz;
+    uint    cap;
+    uint    wasted_;    // Words of freed clauses, reclaimed by moving all live clauses to a new arena.
+
+    void capacity(uint min_cap) {
+        if (min_cap <= cap) return;
+        uint    prev_cap = cap;
+        while (cap < min_cap){
+            // Grow by about 1.5 (the added term keeps it growing from small capacities):
+            uint delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+            cap += delta;
+            if (cap <= prev_cap){
+                fprintf(stderr, "ClauseAllocator: out of 32-bit clause references\n");
+                exit(1); }
+        }
+        memory = xrealloc(memory, cap); }
+
+public:
+    ClauseAllocator(uint start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0) { capacity(start_cap); }
+   ~ClauseAllocator() { xfree(memory); }
+
+    CRef alloc(const vec<Lit>& ps, bool learnt, ClauseId id = ClauseId_NULL) {
+        assert(sizeof(Lit)      == sizeof(uint));
+        assert(sizeof(float)    == sizeof(uint));
+        assert(sizeof(ClauseId) == sizeof(uint));
+        uint    words = Clause::words(ps.size(), learnt, id != ClauseId_NULL);
+        capacity(sz + words);
+        CRef    cr = sz;
+        sz += words;
+        new (&memory[cr]) Clause(learnt, ps, id);
+        return cr; }
+
+    void free(CRef cr) {
+        const Clause& c = (*this)[cr];
+        wasted_ += Clause::words(c.size(), c.learnt(), c.hasId()); }
+
+    Clause&       operator [] (CRef cr)       { return *(Clause*)&memory[cr]; }
+    const Clause& operator [] (CRef cr) const { return *(const Clause*)&memory[cr]; }
+    Clause*       lea         (CRef cr)       { return (Clause*)&memory[cr]; }
+
+    uint size  () const { return sz; }
+    uint wasted() const { return wasted_; }
+
+    // Moves the clause 'cr' to the arena 'to' (unless that already happened) and updates 'cr'.
+    void reloc(CRef& cr, ClauseAllocator& to) {
+        Clause& c = (*this)[cr];
+        if (c.reloced()){ cr = c.relocation(); return; }
+
+        uint    words = Clause::words(c.size(), c.learnt(), c.hasId());
+        CRef    moved = to.sz;
+        to.capacity(to.sz + words);
+        memcpy(&to.memory[moved], &c, sizeof(uint) * words);
+        to.sz += words;
+        c.relocate(moved);
+        cr = moved; }
+
+    void moveTo(ClauseAllocator& to) {
+        xfree(to.memory);
+        to.memory  = memory;
+        to.sz      = sz;
+        to.cap     = cap;
+        to.wasted_ = wasted_;
+        memory = NULL;
+        sz = cap = wasted_ = 0; }
 };
 
-inline Clause* Clause_new(bool learnt, const vec<Lit>& ps, ClauseId id = ClauseId_NULL) {
-    assert(sizeof(Lit)      == sizeof(uint));
-    assert(sizeof(float)    == sizeof(uint));
-    assert(sizeof(ClauseId) == sizeof(uint));
-    void*   mem = xmalloc<char>(sizeof(Clause) + sizeof(uint)*(ps.size() + (int)learnt + (int)(id != ClauseId_NULL)));
-    return new (mem) Clause(learnt, ps, id); }
+
+//=================================================================================================
+// Watcher -- an entry of a watcher list:
+
+
+// The blocker is some literal of the clause other than the watched one. If it is true, the clause
+// is satisfied and 'propagate()' can skip it without looking at the clause itself.
+struct Watcher {
+    CRef    cref;
+    Lit     blocker;
+    Watcher(CRef cr, Lit p) : cref(cr), blocker(p) {}
+    bool operator == (const Watcher& w) const { return cref == w.cref; }
+    bool operator != (const Watcher& w) const { return cref != w.cref; }
+};
+
+
+// The watcher lists of a literal. Binary clauses are kept apart: their blocker is the other literal,
+// which is implied if the watched literal becomes true, so they never have to be looked at.
+struct WatchLists {
+    vec<Watcher>    bin;
+    vec<Watcher>    lng;
+    vec<Watcher>&   of(int size) { return size == 2 ? bin : lng; }
+};
 
 
 //=================================================================================================
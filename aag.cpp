@@ -47,22 +47,28 @@ static auto matchMagic(std::istream &in) -> bool
 	return s == "aag ";
 }
 
+// readline reads a line of nums numbers, followed by up to optional more
+// numbers, and passes them to f.
 template <typename Func>
-auto readline(std::istream &in, int nums, Func f) -> std::istream &
+auto readline(std::istream &in, int nums, Func f, int optional = 0) -> std::istream &
 {
-	std::vector<int> v(nums);
+	std::vector<int> v(nums + optional);
 	size_t i = 0;
 
 	while (!in.eof() && i != v.size()) {
-		if (!isdigit(in.peek()))
+		if (!isdigit(in.peek())) {
+			if (int(i) >= nums)
+				break;
 			throw std::runtime_error("number expected");
+		}
 		v[i++] = readnum(in);
 		skipwhite(in);
 	}
 	nextline(in);
 
-	if (i != v.size())
+	if (int(i) < nums)
 		throw std::runtime_error("too few numbers on line");
+	v.resize(i);
 
 	f(const_cast<std::vector<int> &>(v));
 
@@ -77,6 +83,12 @@ auto AIG::IsOutput(int var) const -> bool
 {
 	return std::find(outputs.cbegin(), outputs.cend(), var) != outputs.cend();
 }
+auto AIG::Properties() const -> std::vector<int>
+{
+	auto ps = outputs;
+	ps.insert(ps.end(), bads.cbegin(), bads.cend());
+	return ps;
+}
 auto AIG::IsGateOutput(int var) const -> bool
 {
 	return std::find_if(gates.cbegin(), gates.cend(),
@@ -106,6 +118,17 @@ auto AIG::FromStream(std::istream &in) -> AIG
 	skipwhite(in);
 	const auto gateLines = readnum(in);
 	skipwhite(in);
+	// AIGER 1.9 headers go on with the numbers of bad state properties,
+	// invariant constraints, justice and fairness properties.
+	const auto badLines = readnum(in);
+	skipwhite(in);
+	const auto constraintLines = readnum(in);
+	skipwhite(in);
+	while (!in.eof() && isdigit(in.peek())) {
+		if (readnum(in) != 0)
+			throw std::runtime_error("justice and fairness properties are not supported");
+		skipwhite(in);
+	}
 	nextline(in);
 
 	AIG aig;
@@ -121,14 +144,30 @@ auto AIG::FromStream(std::istream &in) -> AIG
 	}
 
 	for (count = stateLines; !in.eof() && count != 0; --count) {
-		readline(in, 2,
-		         [&](const std::vector<int> &v) { aig.latches.emplace_back(v[0], v[1]); rec({v[0], v[1]}); });
+		readline(in, 2, [&](const std::vector<int> &v) {
+			// the reset value is 0, 1 or the latch itself if it is
+			// uninitialized.
+			const auto reset = v.size() == 3 ? v[2] : 0;
+			if (reset != 0 && reset != 1 && reset != v[0])
+				throw std::runtime_error("invalid latch reset value");
+			aig.latches.emplace_back(v[0], v[1]);
+			aig.resets.push_back(reset);
+			rec({v[0], v[1]});
+		}, 1);
 	}
 
 	for (count = outputLines; !in.eof() && count != 0; --count) {
 		readline(in, 1, [&](const std::vector<int> &v) { aig.outputs.push_back(v[0]); rec({v[0]}); });
 	}
 
+	for (count = badLines; !in.eof() && count != 0; --count) {
+		readline(in, 1, [&](const std::vector<int> &v) { aig.bads.push_back(v[0]); rec({v[0]}); });
+	}
+
+	for (count = constraintLines; !in.eof() && count != 0; --count) {
+		readline(in, 1, [&](const std::vector<int> &v) { aig.constraints.push_back(v[0]); rec({v[0]}); });
+	}
+
 	for (count = gateLines; !in.eof() && count != 0; --count) {
 		readline(in, 3, [&](const std::vector<int> &v) {
 			aig.gates.emplace_back(v[0], v[1], v[2]);
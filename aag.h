@@ -18,7 +18,10 @@ struct AIG {
 
 	std::vector<int> inputs;
 	std::vector<int> outputs;
+	std::vector<int> bads; // bad state properties of AIGER 1.9
+	std::vector<int> constraints; // invariant constraints of AIGER 1.9
 	std::vector<std::pair<int, int>> latches;
+	std::vector<int> resets; // of the latches: 0, 1 or the latch itself if uninitialized
 	std::vector<And> gates;
 	int lastLit;
 
@@ -27,6 +30,10 @@ struct AIG {
 	auto IsGateOutput(int var) const -> bool;
 	auto IsLatchOutput(int var) const -> bool;
 
+	// Properties returns the literals that mark bad states: the outputs
+	// followed by the bad state properties.
+	auto Properties() const -> std::vector<int>;
+
 	// reads an ASCII formated AIGER file from the istream and returns an
 	// AIG structure containing the parsed data.
 	static auto FromStream(std::istream &) -> AIG;
@@ -0,0 +1,108 @@
+#include "translate.h"
+
+#include <algorithm>
+
+auto AIGtoSATer::abstractMC(int k) const -> Result
+{
+	if (aig.outputs.size() != 1) {
+		throw ErrOutputNotSingular;
+	}
+
+	// every latch has an activation literal for its initial value and its
+	// transitions in all steps. A latch is visible if it is assumed.
+	Solver s;
+	s.default_params = searchParams;
+	SolverCNFer scnfer{s};
+	VarTranslator vars{&scnfer, aig.lastLit/2, k};
+	std::vector<Lit> acts;
+	std::map<Var, size_t> latchOf;
+	for (size_t l = 0; l != aig.latches.size(); l++) {
+		acts.push_back(Lit(s.newVar()));
+		latchOf[var(acts.back())] = l;
+		const auto x = resetLit(vars, l, 0);
+		if (x != lit_Undef)
+			s.addBinary(~acts.back(), x);
+	}
+	andgates(scnfer, vars, 0);
+	C(scnfer, vars, 0);
+
+	std::vector<bool> visible(acts.size(), false);
+	return depthByDepth(k, [&](int d, DepthCheck &depth) {
+		if (d > 0) {
+			for (size_t i = 0; i != acts.size(); i++) {
+				const auto q = vars.toLit(aig.latches[i].first, d);
+				const auto next = vars.toLit(aig.latches[i].second, d - 1);
+				s.addTernary(~acts[i], ~q, next);
+				s.addTernary(~acts[i], q, ~next);
+			}
+			andgates(scnfer, vars, d);
+			C(scnfer, vars, d);
+		}
+
+		const auto bad = vars.toLit(aig.outputs[0], d);
+		const auto act = Lit(s.newVar());
+		s.addBinary(bad, ~act);
+
+		auto refinements = 0;
+		auto sat = l_Undef;
+		while (true) {
+			vec<Lit> assumps{vars.True(), act};
+			for (size_t i = 0; i != acts.size(); i++) {
+				if (visible[i])
+					assumps.push(acts[i]);
+			}
+			sat = solveDepth(s, assumps, depth);
+			if (sat != l_True)
+				break;
+
+			// the abstract counterexample is real if the concrete model
+			// follows the same inputs to a bad state.
+			for (size_t i = 0; i != acts.size(); i++) {
+				if (!visible[i])
+					assumps.push(acts[i]);
+			}
+			for (auto step = 0; step <= d; step++) {
+				for (const auto input : aig.inputs) {
+					const auto x = vars.toLit(input, step);
+					assumps.push(s.model[var(x)] == l_True ? x : ~x);
+				}
+			}
+			sat = solveDepth(s, assumps, depth);
+			if (sat != l_False)
+				break;
+
+			refinements++;
+			for (const auto lit : s.conflict) {
+				const auto it = latchOf.find(var(lit));
+				if (it != latchOf.end())
+					visible[it->second] = true;
+			}
+		}
+
+		// a refutation of the abstract model is one of the concrete model.
+		// Its latches are the abstraction of the next depth.
+		const auto count = std::count(visible.begin(), visible.end(), true);
+		if (sat == l_False) {
+			std::fill(visible.begin(), visible.end(), false);
+			for (const auto lit : s.conflict) {
+				const auto it = latchOf.find(var(lit));
+				if (it != latchOf.end())
+					visible[it->second] = true;
+			}
+		}
+		const auto core = std::count(visible.begin(), visible.end(), true);
+
+		depth.report << ", " << count << " of " << acts.size() << " latches after " << refinements
+		             << " refinements";
+		if (sat == l_False)
+			depth.report << ", " << core << " in the proof";
+		depth.phase.set("visible_latches", int(count));
+		depth.phase.set("core_latches", int(core));
+		depth.phase.set("refinements", refinements);
+
+		s.addUnit(~act);
+		if (sat == l_False)
+			s.addUnit(~bad);
+		return sat;
+	});
+}
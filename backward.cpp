@@ -0,0 +1,68 @@
+#include "translate.h"
+
+auto AIGtoSATer::backwardMC(int k) const -> Result
+{
+	if (aig.outputs.size() != 1) {
+		throw ErrOutputNotSingular;
+	}
+
+	// the forward steps grow from step 0, the backward ones from step k
+	// down. For depths below k they do not meet, so the paths are joined by
+	// equating the latches of their last steps.
+	Solver s;
+	s.default_params = searchParams;
+	SolverCNFer scnfer{s};
+	VarTranslator vars{&scnfer, aig.lastLit/2, k};
+	I(scnfer, vars);
+	andgates(scnfer, vars, k);
+	C(scnfer, vars, k);
+	s.addUnit(vars.toLit(aig.outputs[0], k));
+
+	auto forward = 0, backward = 0;
+	auto notBad = 0, notInitial = 0;
+	return depthByDepth(k, [&](int d, DepthCheck &depth) {
+		const auto f = direction == BmcDirection::Bidirectional ? (d + 1) / 2 : 0;
+		const auto b = d - f;
+		for (; forward < f; forward++) {
+			T(scnfer, vars, forward);
+			C(scnfer, vars, forward + 1);
+		}
+		for (; backward < b; backward++) {
+			andgates(scnfer, vars, k - backward - 1);
+			C(scnfer, vars, k - backward - 1);
+			latchSteps(scnfer, vars, k - backward - 1);
+		}
+
+		// the depths below d are refuted, so no state that many forward
+		// steps from an initial state is bad, and none that many backward
+		// steps from a bad state is initial.
+		for (; notBad < d && notBad <= forward; notBad++) {
+			s.addUnit(~vars.toLit(aig.outputs[0], notBad));
+		}
+		for (; notInitial < d && notInitial <= backward; notInitial++) {
+			vec<Lit> clause;
+			for (size_t l = 0; l != aig.latches.size(); l++) {
+				const auto x = resetLit(vars, l, k - notInitial);
+				if (x != lit_Undef)
+					clause.push(~x);
+			}
+			s.addClause(clause);
+		}
+
+		const auto act = Lit(s.newVar());
+		if (f != k - b) {
+			for (const auto &latch : aig.latches) {
+				const auto x = vars.toLit(latch.first, f), y = vars.toLit(latch.first, k - b);
+				s.addTernary(~act, ~x, y);
+				s.addTernary(~act, x, ~y);
+			}
+		}
+
+		const auto sat = solveDepth(s, {vars.True(), act}, depth);
+		depth.report << ", " << f << " forward and " << b << " backward steps";
+		depth.phase.set("forward", f);
+		depth.phase.set("backward", b);
+		s.addUnit(~act);
+		return sat;
+	});
+}
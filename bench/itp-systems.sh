@@ -0,0 +1,41 @@
+#!/bin/sh
+#
+# Compares the labeled interpolation systems on the advanced examples.
+# Usage: bench/itp-systems.sh [timeout in seconds (default 60)] [dir]
+#
+# For every model and system, the result (OK/FAIL/- on timeout), the run time
+# in seconds and the total number of interpolation iterations are printed.
+
+timeout="${1:-60}"
+dir="${2:-examples/advanced}"
+systems="mcmillan pudlak inverse"
+
+make >/dev/null 2>&1
+
+printf "%-32s" "model"
+for s in $systems
+do
+	printf " %22s" "$s"
+done
+echo
+
+for a in `find $dir -name '*.aag' | sort`
+do
+	printf "%-32s" "`basename $a`"
+	for s in $systems
+	do
+		out=`mktemp`
+		start=`date +%s.%N`
+		timeout $timeout ./boumc -i --itp-system $s -f "$a" > $out 2>&1
+		end=`date +%s.%N`
+
+		result=`tail -1 $out`
+		[ "$result" = "OK" ] || [ "$result" = "FAIL" ] || result="-"
+		iterations=`grep -c '^ITERATION' $out`
+		t=`awk "BEGIN { printf \"%.2f\", $end - $start }"`
+		rm -f $out
+
+		printf " %22s" "$result ${t}s ${iterations}it"
+	done
+	echo
+done
@@ -0,0 +1,452 @@
+#include "circuit.h"
+
+#include <algorithm>
+#include <memory>
+#include <set>
+
+// splitmix64 is used as a stateless random number generator for simulation.
+// The same leaf gets the same values for the same seed.
+static auto splitmix64(uint64_t x) -> uint64_t
+{
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+// CircuitSolver lazily adds the Tseitin encoding of circuit nodes to an
+// incremental Solver. Every node gets its own solver variable, the variables
+// of the leaves are unrelated to the CNFer literals they stand for.
+class CircuitSolver {
+	const Circuit &c;
+	Solver s;
+	std::vector<Var> vars; // node index -> solver variable
+
+public:
+	explicit CircuitSolver(const Circuit &c) : c(c)
+	{
+	}
+
+	// lit returns the solver literal equivalent to the node a.
+	auto lit(Lit a) -> Lit
+	{
+		std::vector<int> stack{var(a)};
+
+		while (!stack.empty()) {
+			const auto n = stack.back();
+			if (n >= (int)vars.size())
+				vars.resize(n + 1, var_Undef);
+			if (vars[n] != var_Undef) {
+				stack.pop_back();
+				continue;
+			}
+
+			const auto x = Lit(n, false);
+			if (!c.isAnd(x)) {
+				vars[n] = s.newVar();
+				if (c.isConst(x))
+					s.addUnit(Lit(vars[n], true));
+				stack.pop_back();
+				continue;
+			}
+
+			const auto in1 = var(c.fanin0(x)), in2 = var(c.fanin1(x));
+			const auto done1 = in1 < (int)vars.size() && vars[in1] != var_Undef;
+			const auto done2 = in2 < (int)vars.size() && vars[in2] != var_Undef;
+			if (!done1)
+				stack.push_back(in1);
+			if (!done2)
+				stack.push_back(in2);
+			if (!done1 || !done2)
+				continue;
+
+			const auto y = Lit(vars[in1], sign(c.fanin0(x)));
+			const auto z = Lit(vars[in2], sign(c.fanin1(x)));
+			const auto v = Lit(vars[n] = s.newVar(), false);
+			s.addBinary(~v, y);
+			s.addBinary(~v, z);
+			s.addTernary(v, ~y, ~z);
+			stack.pop_back();
+		}
+
+		return Lit(vars[var(a)], sign(a));
+	}
+
+	// implies checks whether the node a implies the node b.
+	auto implies(Lit a, Lit b) -> bool
+	{
+		const auto x = lit(a), y = lit(b);
+		return !s.solve({x, ~y});
+	}
+
+	// implies checks the same within the budget that prepare sets.
+	auto implies(Lit a, Lit b, const std::function<void(Solver &)> &prepare) -> lbool
+	{
+		const auto x = lit(a), y = lit(b);
+		prepare(s);
+		return ~s.solveLimited({x, ~y});
+	}
+};
+
+Circuit::Circuit(Lit falseLit) : falseLit(falseLit)
+{
+	nodes.push_back(Node{lit_Undef, lit_Undef, lit_Undef});
+}
+
+auto Circuit::False() const -> Lit
+{
+	return Lit(0, false);
+}
+
+auto Circuit::True() const -> Lit
+{
+	return Lit(0, true);
+}
+
+auto Circuit::leaf(Lit x) -> Lit
+{
+	if (var(x) == var(falseLit))
+		return sign(x) == sign(falseLit) ? False() : True();
+
+	auto it = leaves.find(var(x));
+	if (it != leaves.end())
+		return Lit(it->second, sign(x));
+
+	const int n = nodes.size();
+	nodes.push_back(Node{lit_Undef, lit_Undef, Lit(var(x), false)});
+	leaves[var(x)] = n;
+	return Lit(n, sign(x));
+}
+
+auto Circuit::And(Lit a, Lit b) -> Lit
+{
+	if (a == b)
+		return a;
+	if (a == ~b || a == False() || b == False())
+		return False();
+	if (a == True())
+		return b;
+	if (b == True())
+		return a;
+
+	if (b < a)
+		std::swap(a, b);
+
+	const auto key = (uint64_t(index(a)) << 32) | uint64_t(index(b));
+	auto it = strash.find(key);
+	if (it != strash.end())
+		return Lit(it->second, false);
+
+	const int n = nodes.size();
+	nodes.push_back(Node{a, b, lit_Undef});
+	strash[key] = n;
+	return Lit(n, false);
+}
+
+auto Circuit::Or(Lit a, Lit b) -> Lit
+{
+	return ~And(~a, ~b);
+}
+
+auto Circuit::isLeaf(Lit a) const -> bool
+{
+	return nodes[var(a)].leaf != lit_Undef;
+}
+
+auto Circuit::isAnd(Lit a) const -> bool
+{
+	return nodes[var(a)].in1 != lit_Undef;
+}
+
+auto Circuit::isConst(Lit a) const -> bool
+{
+	return var(a) == 0;
+}
+
+auto Circuit::leafLit(Lit a) const -> Lit
+{
+	assert(isLeaf(a));
+	return id(nodes[var(a)].leaf, sign(a));
+}
+
+auto Circuit::fanin0(Lit a) const -> Lit
+{
+	assert(isAnd(a));
+	return nodes[var(a)].in1;
+}
+
+auto Circuit::fanin1(Lit a) const -> Lit
+{
+	assert(isAnd(a));
+	return nodes[var(a)].in2;
+}
+
+auto Circuit::cone(const std::vector<Lit> &roots) const -> std::vector<int>
+{
+	std::vector<char> seen(nodes.size(), 0);
+	std::vector<int> stack, result;
+
+	for (const auto r : roots)
+		stack.push_back(var(r));
+
+	while (!stack.empty()) {
+		const auto n = stack.back();
+		stack.pop_back();
+		if (n == 0 || seen[n])
+			continue;
+
+		seen[n] = 1;
+		result.push_back(n);
+		if (nodes[n].in1 != lit_Undef) {
+			stack.push_back(var(nodes[n].in1));
+			stack.push_back(var(nodes[n].in2));
+		}
+	}
+
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+auto Circuit::size(Lit root) const -> int
+{
+	const auto c = cone({root});
+	return std::count_if(c.cbegin(), c.cend(), [&](int n) { return nodes[n].in1 != lit_Undef; });
+}
+
+auto Circuit::fromCNF(const vec<vec<Lit>> &clauses) -> Lit
+{
+	auto result = True();
+
+	for (const auto &clause : clauses) {
+		auto c = False();
+		for (const auto x : clause)
+			c = Or(c, leaf(x));
+		result = And(result, c);
+	}
+
+	return result;
+}
+
+auto Circuit::toCNF(Lit root, CNFer &s) const -> Lit
+{
+	std::vector<Lit> m(nodes.size(), lit_Undef);
+	m[0] = falseLit;
+
+	for (const auto n : cone({root})) {
+		const auto &node = nodes[n];
+		if (node.leaf != lit_Undef) {
+			m[n] = node.leaf;
+			continue;
+		}
+
+		const auto y = id(m[var(node.in1)], sign(node.in1));
+		const auto z = id(m[var(node.in2)], sign(node.in2));
+		const auto x = Lit(s.newVar(), false);
+		s.addBinary(~x, y);
+		s.addBinary(~x, z);
+		s.addTernary(x, ~y, ~z);
+		m[n] = x;
+	}
+
+	return id(m[var(root)], sign(root));
+}
+
+auto Circuit::remap(Lit root, const std::function<Lit(Lit)> &f) -> Lit
+{
+	const auto order = cone({root});
+	std::vector<Lit> m(nodes.size(), lit_Undef);
+	m[0] = False();
+
+	for (const auto n : order) {
+		// copy the node, because leaf() and And() may reallocate `nodes`.
+		const auto node = nodes[n];
+		if (node.leaf != lit_Undef)
+			m[n] = leaf(f(node.leaf));
+		else
+			m[n] = And(id(m[var(node.in1)], sign(node.in1)),
+			           id(m[var(node.in2)], sign(node.in2)));
+	}
+
+	return id(m[var(root)], sign(root));
+}
+
+auto Circuit::simulate(const std::vector<Lit> &roots, int words, uint64_t seed) const
+    -> std::vector<uint64_t>
+{
+	std::vector<uint64_t> sig(nodes.size() * words, 0);
+
+	for (const auto n : cone(roots)) {
+		auto *out = &sig[n * words];
+		const auto &node = nodes[n];
+
+		if (node.leaf != lit_Undef) {
+			const auto base = splitmix64(seed ^ uint64_t(var(node.leaf)));
+			for (int w = 0; w != words; w++)
+				out[w] = splitmix64(base + w);
+			continue;
+		}
+
+		const auto *a = &sig[var(node.in1) * words];
+		const auto *b = &sig[var(node.in2) * words];
+		const auto ma = sign(node.in1) ? ~uint64_t(0) : 0;
+		const auto mb = sign(node.in2) ? ~uint64_t(0) : 0;
+		for (int w = 0; w != words; w++)
+			out[w] = (a[w] ^ ma) & (b[w] ^ mb);
+	}
+
+	return sig;
+}
+
+auto Circuit::disjuncts(Lit root) const -> std::vector<Lit>
+{
+	// ~(x & y) = ~x | ~y
+	std::vector<Lit> result, stack{root};
+	std::set<int> seen;
+
+	while (!stack.empty()) {
+		const auto x = stack.back();
+		stack.pop_back();
+		if (!seen.insert(index(x)).second)
+			continue;
+		if (sign(x) && isAnd(x)) {
+			stack.push_back(~fanin0(~x));
+			stack.push_back(~fanin1(~x));
+		} else if (x != False()) {
+			result.push_back(x);
+		}
+	}
+
+	return result;
+}
+
+auto Circuit::mayImply(Lit a, Lit b, int words, uint64_t seed) const -> bool
+{
+	const auto sig = simulate({a, b}, words, seed);
+	const auto *sa = &sig[var(a) * words];
+	const auto *sb = &sig[var(b) * words];
+	const auto ma = sign(a) ? ~uint64_t(0) : 0;
+	const auto mb = sign(b) ? ~uint64_t(0) : 0;
+
+	for (int w = 0; w != words; w++)
+		if ((sa[w] ^ ma) & ~(sb[w] ^ mb))
+			return false;
+
+	return true;
+}
+
+auto Circuit::implies(Lit a, Lit b, const std::function<void(Solver &)> &prepare) const -> lbool
+{
+	if (a == False() || b == True() || a == b)
+		return l_True;
+
+	CircuitSolver solver(*this);
+	return solver.implies(a, b, prepare);
+}
+
+auto Circuit::sweep(Lit root, int maxChecks) -> Lit
+{
+	if (!isAnd(root))
+		return root;
+
+	const int W = 4;
+	const int oldSize = nodes.size();
+	const auto order = cone({root});
+	const auto sig = simulate({root}, W, 0x5eed);
+
+	// phase-normalized signatures: a node and its negation end up in the
+	// same class.
+	auto phase = [&](int n) -> bool { return sig[n * W] & 1; };
+	auto hash = [&](int n) -> uint64_t {
+		const auto mask = phase(n) ? ~uint64_t(0) : 0;
+		uint64_t h = 0;
+		for (int w = 0; w != W; w++)
+			h = splitmix64(h ^ (sig[n * W + w] ^ mask));
+		return h;
+	};
+	auto sameClass = [&](int n, int m) -> bool {
+		const auto mask = (phase(n) != phase(m)) ? ~uint64_t(0) : 0;
+		for (int w = 0; w != W; w++)
+			if (sig[n * W + w] != (sig[m * W + w] ^ mask))
+				return false;
+		return true;
+	};
+
+	std::vector<Lit> repl(oldSize, lit_Undef);
+	auto mapped = [&](Lit x) { return id(repl[var(x)], sign(x)); };
+	std::unordered_map<uint64_t, std::vector<int>> classes;
+
+	repl[0] = False();
+	classes[hash(0)].push_back(0);
+
+	std::unique_ptr<CircuitSolver> solver;
+	int checks = 0;
+
+	for (const auto n : order) {
+		const auto node = nodes[n];
+		if (node.leaf != lit_Undef) {
+			repl[n] = Lit(n, false);
+			classes[hash(n)].push_back(n);
+			continue;
+		}
+
+		const auto m = And(mapped(node.in1), mapped(node.in2));
+		repl[n] = m;
+
+		auto &cls = classes[hash(n)];
+		auto merged = false;
+		for (const auto r : cls) {
+			if (!sameClass(n, r))
+				continue;
+
+			const auto cand = id(repl[r], phase(n) != phase(r));
+			if (cand == m) {
+				merged = true;
+				break;
+			}
+			if (checks >= maxChecks)
+				break;
+
+			if (!solver)
+				solver = std::make_unique<CircuitSolver>(*this);
+			checks++;
+			if (solver->implies(m, cand) && solver->implies(cand, m)) {
+				repl[n] = cand;
+				merged = true;
+				break;
+			}
+		}
+
+		if (!merged)
+			cls.push_back(n);
+	}
+
+	return mapped(root);
+}
+
+auto Circuit::dropSubsumed(Lit root, Lit by, int maxChecks) -> Lit
+{
+	if (isConst(root))
+		return root;
+	if (by == True())
+		return False();
+
+	const auto ds = disjuncts(root);
+
+	CircuitSolver solver(*this);
+	auto result = False();
+	auto dropped = false;
+	int checks = 0;
+
+	for (const auto d : ds) {
+		if (checks < maxChecks) {
+			checks++;
+			if (solver.implies(d, by)) {
+				dropped = true;
+				continue;
+			}
+		}
+		result = Or(result, d);
+	}
+
+	return dropped ? result : root;
+}
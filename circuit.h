@@ -0,0 +1,106 @@
+#pragma once
+
+#include "MiniSat-p_v1.14/Solver.h"
+#include "cnfer.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// Circuit is a structurally hashed And-Inverter graph whose leaves are
+// literals of a CNFer (usually variables handed out by a VarTranslator).
+// It is used to represent interpolants and the reachable state sets built
+// from them, because a circuit can be simplified much more easily than the
+// Tseitin clauses that are eventually given to a Solver.
+//
+// Nodes are referenced by literals over node indices. Node 0 is the constant
+// false, so Lit(0, false) is False() and Lit(0, true) is True().
+class Circuit {
+	struct Node {
+		Lit in1, in2; // fanins of an And node (lit_Undef for leaves)
+		Lit leaf;     // the CNFer literal of a leaf (lit_Undef for And nodes)
+	};
+
+	Lit falseLit;
+	std::vector<Node> nodes;
+	std::unordered_map<uint64_t, int> strash;
+	std::map<Var, int> leaves;
+
+	// cone returns the indices of all nodes in the cone of influence of the
+	// roots in topological (i.e. ascending) order, excluding node 0.
+	auto cone(const std::vector<Lit> &roots) const -> std::vector<int>;
+
+public:
+	// falseLit is the CNFer literal that represents the constant false
+	// (VarTranslator::False()). Leaves on its variable become constants.
+	explicit Circuit(Lit falseLit);
+
+	auto False() const -> Lit;
+	auto True() const -> Lit;
+
+	// leaf returns the node for the CNFer literal x.
+	auto leaf(Lit x) -> Lit;
+
+	// And returns a node equivalent to (a & b). Trivial cases are simplified
+	// and structurally identical nodes are shared.
+	auto And(Lit a, Lit b) -> Lit;
+
+	// Or returns a node equivalent to (a | b).
+	auto Or(Lit a, Lit b) -> Lit;
+
+	auto isLeaf(Lit a) const -> bool;
+	auto isAnd(Lit a) const -> bool;
+	auto isConst(Lit a) const -> bool;
+
+	// leafLit returns the CNFer literal of a leaf node (respecting the sign of a).
+	auto leafLit(Lit a) const -> Lit;
+
+	// fanin0 and fanin1 return the inputs of an And node.
+	auto fanin0(Lit a) const -> Lit;
+	auto fanin1(Lit a) const -> Lit;
+
+	// size returns the number of And nodes in the cone of root.
+	auto size(Lit root) const -> int;
+
+	// fromCNF returns a node equivalent to the conjunction of the clauses.
+	auto fromCNF(const vec<vec<Lit>> &clauses) -> Lit;
+
+	// toCNF adds the Tseitin encoding of the cone of root to the CNFer and
+	// returns the CNFer literal that is equivalent to root. Fresh variables
+	// for And nodes are taken from s.newVar().
+	auto toCNF(Lit root, CNFer &s) const -> Lit;
+
+	// remap rebuilds the cone of root with every leaf literal x replaced by
+	// f(x). This is used to shift interpolants in time.
+	auto remap(Lit root, const std::function<Lit(Lit)> &f) -> Lit;
+
+	// simulate computes bit-parallel signatures of all nodes in the cone of
+	// the roots for `words` 64-bit words of random leaf values. The result is
+	// indexed by node index, words*index is the first word of a node.
+	auto simulate(const std::vector<Lit> &roots, int words, uint64_t seed) const
+	    -> std::vector<uint64_t>;
+
+	// disjuncts returns the top-level disjuncts of root, i.e. root is
+	// equivalent to the disjunction of the result. False is omitted.
+	auto disjuncts(Lit root) const -> std::vector<Lit>;
+
+	// mayImply simulates a and b with random leaf values. It returns false if
+	// an assignment with a = 1 and b = 0 was found, and true otherwise.
+	auto mayImply(Lit a, Lit b, int words = 16, uint64_t seed = 0x5eed) const -> bool;
+
+	// implies checks with a Solver whether a implies b. prepare is called
+	// before the Solver starts, e.g. to set a budget. l_Undef is returned if
+	// the Solver ran out of it or was interrupted.
+	auto implies(Lit a, Lit b, const std::function<void(Solver &)> &prepare) const -> lbool;
+
+	// sweep merges functionally equivalent nodes in the cone of root. Candidates
+	// are found by simulation and proven with an incremental Solver. At most
+	// maxChecks SAT calls are made. The returned node is equivalent to root.
+	auto sweep(Lit root, int maxChecks = 1000) -> Lit;
+
+	// dropSubsumed removes the top-level disjuncts of root that imply `by`.
+	// The result r satisfies (r | by) <-> (root | by).
+	auto dropSubsumed(Lit root, Lit by, int maxChecks = 1000) -> Lit;
+};
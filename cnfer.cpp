@@ -2,6 +2,18 @@
 
 #include <algorithm>
 
+void CNFer::addClauses(const vec<Lit> &lits, const vec<int> &sizes)
+{
+    vec<Lit> clause;
+    for (int i = 0, j = 0; i < sizes.size(); i++) {
+        clause.clear();
+        for (const auto end = j + sizes[i]; j < end; j++) {
+            clause.push(lits[j]);
+        }
+        addClause(clause);
+    }
+}
+
 VecCNFer::VecCNFer()
 {
 }
@@ -71,6 +83,23 @@ void VecCNFer::addTernary(Lit a, Lit b, Lit c)
     v.push({a,b,c});
 }
 
+void VecCNFer::addClauses(const vec<Lit> &lits, const vec<int> &sizes)
+{
+    if (litset) {
+        CNFer::addClauses(lits, sizes);
+        return;
+    }
+
+    for (int i = 0, j = 0; i < sizes.size(); i++) {
+        v.push();
+        auto &clause = v.last();
+        clause.capacity(sizes[i]);
+        for (const auto end = j + sizes[i]; j < end; j++) {
+            clause.push(lits[j]);
+        }
+    }
+}
+
 Var VecCNFer::newVar()
 {
     if(newv) {
@@ -155,8 +184,10 @@ SolverCNFer::SolverCNFer(Solver &s) : s(s)
 }
 
 void SolverCNFer::ensureVars(Var upTo) {
-    while(upTo > s.newVar()){}
-} 
+    while(upTo >= s.nVars()) {
+        s.newVar();
+    }
+}
 
 SolverCNFer::~SolverCNFer()
 {
@@ -187,6 +218,15 @@ void SolverCNFer::addTernary(Lit a, Lit b, Lit c)
     s.addTernary(a, b, c);
 }
 
+void SolverCNFer::addClauses(const vec<Lit> &lits, const vec<int> &sizes)
+{
+    if (lits.size() == 0) {
+        return;
+    }
+    ensureVars(var(*std::max_element(lits.cbegin(), lits.cend())));
+    s.addClauses(lits, sizes);
+}
+
 Var SolverCNFer::newVar()
 {
     return s.newVar();
@@ -15,6 +15,10 @@ struct CNFer {
 	virtual void addTernary(Lit, Lit, Lit) = 0;
 	virtual auto newVar() -> Var = 0;
 	virtual ~CNFer(){};
+
+	// addClauses adds clauses stored one after another in lits, sizes[i]
+	// literals each. CNFers can load them in bulk.
+	virtual void addClauses(const vec<Lit> &lits, const vec<int> &sizes);
 };
 
 class VecCNFer : public CNFer {
@@ -54,6 +58,7 @@ public:
 	virtual void addBinary(Lit a, Lit b);
 	virtual void addTernary(Lit a, Lit b, Lit c);
 	virtual auto newVar() -> Var;
+	virtual void addClauses(const vec<Lit> &lits, const vec<int> &sizes);
 
 	// copy all clauses to another CNFer.
 	void copyTo(CNFer& s) const;
@@ -69,6 +74,11 @@ public:
 		return v;
 	}
 
+	auto raw() const -> const container_type&
+	{
+		return v;
+	}
+
 	// check if the variable of the literal is contained in the CNF stored.
 	// when setRecordUsedVariables(true) was called before any clauses were added,
 	// this check can be performed efficiently.
@@ -91,6 +101,7 @@ public:
 	virtual void addBinary(Lit a, Lit b);
 	virtual void addTernary(Lit a, Lit b, Lit c);
 	virtual auto newVar() -> Var;
+	virtual void addClauses(const vec<Lit> &lits, const vec<int> &sizes);
 
 	auto solver() -> Solver&;
 };
@@ -0,0 +1,150 @@
+#include "cubes.h"
+#include "MiniSat-p_v1.14/SimpSolver.h"
+#include "workers.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+CubeAndConquer::CubeAndConquer(int workers, int depth, const SearchParams &params)
+    : workers(workers), depth(depth), params(params)
+{
+	assert(workers > 0 && depth >= 0);
+}
+
+void CubeAndConquer::setVariableElimination(bool yes)
+{
+	variableElimination = yes;
+}
+
+void CubeAndConquer::split(Solver &s, const std::vector<Var> &candidates, vec<Lit> &cube)
+{
+	if (s.lookahead(cube, lit_Undef) < 0) {
+		refuted++;
+		return;
+	}
+
+	// as in march, both values of a good splitting variable imply many
+	// assignments. Failed literals and assigned variables are skipped.
+	auto best = var_Undef;
+	int64_t bestScore = 0;
+	if (cube.size() != depth) {
+		for (const auto v : candidates) {
+			const int64_t pos = s.lookahead(cube, Lit(v));
+			const int64_t neg = s.lookahead(cube, ~Lit(v));
+			if (pos < 0 && neg < 0) {
+				refuted++;
+				return;
+			}
+			if (pos > 0 && neg > 0 && (pos + 1) * (neg + 1) > bestScore) {
+				best = v;
+				bestScore = (pos + 1) * (neg + 1);
+			}
+		}
+	}
+
+	if (best == var_Undef) {
+		cubes.emplace_back();
+		for (const auto lit : cube) {
+			cubes.back().lits.push_back(lit);
+		}
+		return;
+	}
+
+	for (const auto lit : {Lit(best), ~Lit(best)}) {
+		cube.push(lit);
+		split(s, candidates, cube);
+		cube.pop();
+	}
+}
+
+auto CubeAndConquer::solve(const VecCNFer &cnf, const std::vector<Var> &candidates,
+                           const std::function<void(Solver &)> &prepare) -> lbool
+{
+	cubes.clear();
+	refuted = 0;
+
+	std::atomic<bool> stop{false};
+	std::atomic<bool> *outer = nullptr;
+
+	// the candidates are frozen, so all cubes can be assumed in every worker.
+	std::vector<std::unique_ptr<SimpSolver>> solvers;
+	for (auto i = 0; i != workers; i++) {
+		solvers.push_back(std::make_unique<SimpSolver>());
+		auto &s = *solvers.back();
+		s.default_params = params;
+		s.use_elim = variableElimination;
+
+		SolverCNFer scnfer{s};
+		cnf.copyTo(scnfer);
+		for (const auto v : candidates) {
+			s.setFrozen(v, true);
+		}
+
+		prepare(s);
+		outer = s.interrupt_flag;
+	}
+
+	// the cubes are generated by worker 0, the others eliminate variables
+	// in their own thread when they solve their first cube.
+	auto &first = *solvers[0];
+	if (variableElimination && !first.eliminate()) {
+		return l_False;
+	}
+	vec<Lit> root;
+	split(first, candidates, root);
+
+	std::atomic<size_t> next{0};
+	std::mutex m;
+	auto satisfiable = false;
+
+	// idle workers take the next unsolved cube.
+	const auto solveCubes = [&](int i) {
+		auto &s = *solvers[i];
+		for (size_t n; !stop.load() && (n = next++) < cubes.size();) {
+			auto &cube = cubes[n];
+			vec<Lit> assumps;
+			for (const auto lit : cube.lits) {
+				assumps.push(lit);
+			}
+
+			prepare(s);
+			s.interrupt_flag = &stop;
+			const auto conflicts = s.stats.conflicts;
+			const auto decisions = s.stats.decisions;
+			const auto start = std::chrono::steady_clock::now();
+			const auto r = s.solveLimited(assumps);
+
+			cube.result = r;
+			cube.worker = i;
+			cube.conflicts = s.stats.conflicts - conflicts;
+			cube.decisions = s.stats.decisions - decisions;
+			cube.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (r == l_True) {
+				std::lock_guard<std::mutex> lock(m);
+				satisfiable = true;
+				stop.store(true);
+			}
+		}
+	};
+	runWorkers(workers, solveCubes, *outer, [&] { stop.store(true); });
+
+	if (satisfiable)
+		return l_True;
+	for (const auto &cube : cubes) {
+		if (cube.result != l_False)
+			return l_Undef;
+	}
+	return l_False;
+}
+
+auto CubeAndConquer::solvedCubes() const -> const std::vector<Cube> &
+{
+	return cubes;
+}
+
+auto CubeAndConquer::refutedCubes() const -> int
+{
+	return refuted;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MiniSat-p_v1.14/Solver.h"
+#include "cnfer.h"
+
+#include <functional>
+#include <vector>
+
+// CubeAndConquer splits a CNF into cubes (conjunctions of literals) and
+// solves them as assumptions on a pool of incremental solvers running in
+// parallel threads. The formula is satisfiable iff one of the cubes is, so
+// the first satisfiable cube stops all workers.
+class CubeAndConquer {
+public:
+	// Cube records a cube and how it was solved.
+	struct Cube {
+		std::vector<Lit> lits;
+		lbool result = l_Undef;
+		int worker = -1; // -1 if the cube was never started
+		int64_t conflicts = 0;
+		int64_t decisions = 0;
+		double seconds = 0;
+	};
+
+private:
+	int workers;
+	int depth;
+	SearchParams params;
+	bool variableElimination = true;
+	std::vector<Cube> cubes;
+	int refuted = 0;
+
+	// split generates the cubes below cube by lookahead in s.
+	void split(Solver &s, const std::vector<Var> &candidates, vec<Lit> &cube);
+
+public:
+	// depth is the number of variables every cube is split on.
+	CubeAndConquer(int workers, int depth, const SearchParams &params);
+
+	// setVariableElimination turns preprocessing in every worker on or off.
+	// It is turned on by default.
+	void setVariableElimination(bool yes);
+
+	// solve solves cnf. The cubes are built from the candidates: at every
+	// node of the splitting tree, the variable whose two values imply the
+	// most assignments by propagation is chosen. prepare is called before
+	// every cube is solved, e.g. to set a budget. Setting the interrupt flag
+	// that prepare leaves in a worker stops all of them. l_Undef is
+	// returned if no cube was satisfiable, but some ran out of their budget
+	// or the workers were interrupted.
+	auto solve(const VecCNFer &cnf, const std::vector<Var> &candidates,
+	           const std::function<void(Solver &)> &prepare) -> lbool;
+
+	// solvedCubes returns the cubes of the last solve() with their results.
+	auto solvedCubes() const -> const std::vector<Cube> &;
+
+	// refutedCubes returns the number of cubes of the last solve() that were
+	// refuted by propagation while splitting.
+	auto refutedCubes() const -> int;
+};
@@ -0,0 +1,223 @@
+#include "translate.h"
+
+// gateOrder returns the indices of the gates of aig in topological order.
+static auto gateOrder(const AIG &aig) -> std::vector<size_t>
+{
+	std::vector<int> gateOf(aig.lastLit/2 + 1, -1);
+	for (size_t i = 0; i != aig.gates.size(); i++) {
+		gateOf[aig.gates[i].out/2] = i;
+	}
+
+	std::vector<size_t> order;
+	std::vector<bool> done(aig.gates.size());
+	std::vector<std::pair<size_t, bool>> stack;
+	for (size_t i = 0; i != aig.gates.size(); i++) {
+		stack.emplace_back(i, false);
+		while (!stack.empty()) {
+			const auto g = stack.back().first;
+			const auto expanded = stack.back().second;
+			stack.pop_back();
+			if (done[g])
+				continue;
+			if (expanded) {
+				done[g] = true;
+				order.push_back(g);
+				continue;
+			}
+			stack.emplace_back(g, true);
+			for (const auto in : {aig.gates[g].in1, aig.gates[g].in2}) {
+				const auto h = gateOf[in/2];
+				if (h >= 0 && !done[h])
+					stack.emplace_back(h, false);
+			}
+		}
+	}
+	return order;
+}
+
+// ternaryOutput simulates the steps 0..step of aig with the values 0, 1 and
+// 2 (unknown). latches holds the values of the latches at step 0 in the order
+// of aig.latches and inputs[i] the ones of the inputs at step i. order is the
+// gateOrder of aig. It returns the value of the output at step, and of the
+// invariant constraints in all steps.
+static auto ternaryOutput(const AIG &aig, const std::vector<size_t> &order, std::vector<char> latches,
+                          const std::vector<std::vector<char>> &inputs, int step) -> char
+{
+	std::vector<char> value(aig.lastLit/2 + 1, 0);
+	const auto get = [&](int lit) -> char {
+		const auto v = value[lit/2];
+		return v == 2 ? 2 : v ^ (lit & 1);
+	};
+	const auto and2 = [](char a, char b) -> char { return a == 0 || b == 0 ? 0 : a == 1 && b == 1 ? 1 : 2; };
+	auto constrained = char(1);
+	for (auto i = 0;; i++) {
+		for (size_t l = 0; l != latches.size(); l++) {
+			value[aig.latches[l].first/2] = latches[l];
+		}
+		for (size_t n = 0; n != aig.inputs.size(); n++) {
+			value[aig.inputs[n]/2] = inputs[i][n];
+		}
+		for (const auto g : order) {
+			const auto &gate = aig.gates[g];
+			value[gate.out/2] = and2(get(gate.in1), get(gate.in2));
+		}
+		for (const auto c : aig.constraints) {
+			constrained = and2(constrained, get(c));
+		}
+		if (i == step)
+			return and2(constrained, get(aig.outputs[0]));
+		for (size_t l = 0; l != latches.size(); l++) {
+			latches[l] = get(aig.latches[l].second);
+		}
+	}
+}
+
+auto AIGtoSATer::enlargeTarget(int steps, int maxCubes, int64_t maxConflicts) const -> EnlargedTarget
+{
+	if (aig.outputs.size() != 1) {
+		throw ErrOutputNotSingular;
+	}
+
+	// the unrolling starts in any state. latchOf maps the latches of step 0
+	// back to their index in aig.latches.
+	Solver s;
+	s.default_params = searchParams;
+	SolverCNFer scnfer{s};
+	VarTranslator vars{&scnfer, aig.lastLit/2, steps};
+	andgates(scnfer, vars, 0);
+	C(scnfer, vars, 0);
+	std::map<Var, size_t> latchOf;
+	for (size_t l = 0; l != aig.latches.size(); l++) {
+		latchOf[var(vars.toLit(aig.latches[l].first, 0))] = l;
+	}
+	const auto order = gateOrder(aig);
+
+	EnlargedTarget target{aig};
+	std::vector<std::vector<Lit>> cubes;
+	const auto block = [&](const std::vector<Lit> &cube, Lit act) {
+		vec<Lit> clause{~act};
+		for (const auto lit : cube) {
+			clause.push(~lit);
+		}
+		s.addClause(clause);
+	};
+
+	for (auto i = 1; i <= steps; i++) {
+		T(scnfer, vars, i - 1);
+		C(scnfer, vars, i);
+
+		// under act, the state of step 0 reaches a bad state at step i and
+		// is not covered by a cube yet. Under sim, it does not reach one.
+		const auto bad = vars.toLit(aig.outputs[0], i);
+		const auto act = Lit(s.newVar()), sim = Lit(s.newVar());
+		s.addBinary(~act, bad);
+		s.addBinary(~sim, ~bad);
+		for (const auto &cube : cubes) {
+			block(cube, act);
+		}
+
+		const auto found = cubes.size();
+		auto complete = false;
+		while (cubes.size() - found < size_t(maxCubes)) {
+			s.budgetOff();
+			s.interrupt_flag = &interrupted;
+			s.setConfBudget(maxConflicts);
+			const auto sat = s.solveLimited({vars.True(), act});
+			if (sat != l_True) {
+				complete = sat == l_False;
+				break;
+			}
+
+			// the state and the inputs found lead to a bad state by
+			// propagation alone. The conflict of the simulation keeps the
+			// latches that this depends on.
+			const auto value = [&](Lit x) -> char { return s.model[var(x)] == l_True; };
+			vec<Lit> assumps{vars.True(), sim};
+			std::vector<std::vector<char>> inputs(i + 1);
+			for (auto step = 0; step <= i; step++) {
+				for (const auto input : aig.inputs) {
+					const auto x = vars.toLit(input, step);
+					inputs[step].push_back(value(x));
+					assumps.push(value(x) ? x : ~x);
+				}
+			}
+			for (const auto &latch : aig.latches) {
+				const auto x = vars.toLit(latch.first, 0);
+				assumps.push(value(x) ? x : ~x);
+			}
+			s.budgetOff();
+			// the simulation cannot be sat, but an interrupt still stops it.
+			if (s.solveLimited(assumps) != l_False) {
+				break;
+			}
+
+			std::vector<Lit> cube;
+			std::vector<char> latches(aig.latches.size(), 2);
+			for (const auto lit : s.conflict) {
+				const auto l = latchOf.find(var(lit));
+				if (l != latchOf.end()) {
+					cube.push_back(~lit);
+					latches[l->second] = !sign(~lit);
+				}
+			}
+
+			// the conflict leaves out the literals fixed at level 0, such
+			// as the ones of the invariant constraints. If it is too weak
+			// without them, the cube starts from the full state instead.
+			if (ternaryOutput(aig, order, latches, inputs, i) != 1) {
+				cube.clear();
+				for (size_t l = 0; l != aig.latches.size(); l++) {
+					const auto x = vars.toLit(aig.latches[l].first, 0);
+					cube.push_back(value(x) ? x : ~x);
+					latches[l] = value(x);
+				}
+			}
+
+			// a latch can also be dropped if ternary simulation still
+			// reaches the bad state without it.
+			for (size_t j = 0; j < cube.size();) {
+				const auto l = latchOf[var(cube[j])];
+				const auto v = latches[l];
+				latches[l] = 2;
+				if (ternaryOutput(aig, order, latches, inputs, i) == 1) {
+					cube.erase(cube.begin() + j);
+				} else {
+					latches[l] = v;
+					j++;
+				}
+			}
+			cubes.push_back(cube);
+			block(cube, act);
+		}
+		s.addUnit(~act);
+		s.addUnit(~sim);
+
+		if (!complete) {
+			cubes.resize(found);
+			break;
+		}
+		target.steps = i;
+	}
+
+	// output = bad | cube_1 | cube_2 | ..., built from new And gates.
+	auto &g = target.aig;
+	const auto gate = [&](int in1, int in2) {
+		const auto out = (g.lastLit/2 + 1) * 2;
+		g.lastLit = out;
+		g.gates.emplace_back(out, in1, in2);
+		return out;
+	};
+	auto any = g.outputs[0];
+	for (const auto &cube : cubes) {
+		auto all = 1;
+		for (const auto lit : cube) {
+			const auto x = aig.latches[latchOf[var(lit)]].first + (sign(lit) ? 1 : 0);
+			all = all == 1 ? x : gate(all, x);
+		}
+		any = gate(any ^ 1, all ^ 1) ^ 1;
+	}
+	g.outputs[0] = any;
+	target.cubes = cubes.size();
+
+	return target;
+}
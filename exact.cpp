@@ -0,0 +1,36 @@
+#include "translate.h"
+
+auto AIGtoSATer::exactMC(int k) const -> Result
+{
+	if (aig.outputs.size() != 1) {
+		throw ErrOutputNotSingular;
+	}
+
+	Solver s;
+	s.default_params = searchParams;
+	SolverCNFer scnfer{s};
+	VarTranslator vars{&scnfer, aig.lastLit/2, k};
+	if (latchAliasing)
+		vars.aliasLatches(aig.latches);
+	I(scnfer, vars);
+
+	return depthByDepth(k, [&](int d, DepthCheck &depth) {
+		if (d > 0) {
+			T(scnfer, vars, d - 1);
+			C(scnfer, vars, d);
+		}
+
+		// the bad state of this depth is only required under act, which is
+		// turned off for good once the depth is refuted.
+		const auto bad = vars.toLit(aig.outputs[0], d);
+		const auto act = Lit(s.newVar());
+		s.addBinary(bad, ~act);
+
+		const auto sat = solveDepth(s, {vars.True(), act}, depth);
+		if (sat == l_False) {
+			s.addUnit(~act);
+			s.addUnit(~bad);
+		}
+		return sat;
+	});
+}
@@ -0,0 +1,233 @@
+#include "interpolant.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+const char VertexRoot[] = "root";
+const char VertexChain[] = "chain";
+
+auto parseItpSystem(const std::string &name) -> ItpSystem
+{
+	if (name == "mcmillan")
+		return ItpSystem::McMillan;
+	if (name == "pudlak")
+		return ItpSystem::Pudlak;
+	if (name == "inverse")
+		return ItpSystem::InverseMcMillan;
+
+	throw std::invalid_argument("unknown interpolation system '" + name + "'");
+}
+
+void ItpPartitions::add(const VecCNFer &clauses, int part)
+{
+	for (const auto &clause : clauses.raw()) {
+		for (const auto x : clause) {
+			const auto v = var(x);
+			if (v >= (int)first.size()) {
+				first.resize(v + 1, INT_MAX);
+				last.resize(v + 1, INT_MIN);
+			}
+			first[v] = std::min(first[v], part);
+			last[v] = std::max(last[v], part);
+		}
+	}
+}
+
+auto ItpPartitions::inA(Var v, int cut) const -> bool
+{
+	return v < (int)first.size() && first[v] <= cut;
+}
+
+auto ItpPartitions::inB(Var v, int cut) const -> bool
+{
+	return v < (int)last.size() && last[v] > cut;
+}
+
+// Label is the label of a variable in a labeled interpolation system.
+enum Label { LabelA = 1, LabelB = 2, LabelAB = LabelA | LabelB };
+
+static auto label(const ItpContext &ctx, Var v) -> Label
+{
+	const auto inA = ctx.parts.inA(v, ctx.cut), inB = ctx.parts.inB(v, ctx.cut);
+
+	if (!inB)
+		return LabelA;
+	if (!inA)
+		return LabelB;
+
+	// shared variable
+	switch (ctx.system) {
+	case ItpSystem::McMillan:
+		return LabelB;
+	case ItpSystem::Pudlak:
+		return LabelAB;
+	case ItpSystem::InverseMcMillan:
+		return LabelA;
+	}
+
+	throw std::domain_error("unknown interpolation system");
+}
+
+// resolve sets c to the resolvent of c and d on the variable v. Both clauses
+// are sorted and do not contain duplicates, the result is sorted as well.
+static void resolve(vec<Lit> &c, const vec<Lit> &d, Var v)
+{
+	vec<Lit> r;
+	auto i = c.cbegin(), j = d.cbegin();
+
+	while (i != c.cend() || j != d.cend()) {
+		Lit x;
+		if (j == d.cend() || (i != c.cend() && *i < *j))
+			x = *i++;
+		else if (i == c.cend() || *j < *i)
+			x = *j++;
+		else
+			x = *i++, j++;
+
+		if (var(x) != v)
+			r.push(x);
+	}
+
+	r.moveTo(c);
+}
+
+// rootItp returns the partial interpolant of a root clause c of partition part.
+static auto rootItp(const ItpContext &ctx, const vec<Lit> &c, int part) -> Lit
+{
+	auto &itp = ctx.itp;
+	Lit lit;
+
+	if (part <= ctx.cut) {
+		// p(c) is the disjunction of the literals of c labeled b.
+		lit = itp.False();
+		for(const auto x : c) {
+			if(label(ctx, var(x)) == LabelB) {
+				lit = itp.Or(lit, itp.leaf(x));
+			}
+		}
+	} else {
+		// p(c) is the conjunction of the negated literals of c labeled a.
+		lit = itp.True();
+		for(const auto x : c) {
+			if(label(ctx, var(x)) == LabelA) {
+				lit = itp.And(lit, itp.leaf(~x));
+			}
+		}
+	}
+
+	return lit;
+}
+
+// resolventItp returns the partial interpolant of the resolvent of c1 and c2 on
+// the pivot v, given their partial interpolants pc1 and pc2. c1 is only needed
+// for Pudlak's system.
+static auto resolventItp(const ItpContext &ctx, const vec<Lit> &c1, Lit pc1, Lit pc2, Var v) -> Lit
+{
+	auto &itp = ctx.itp;
+
+	switch (label(ctx, v)) {
+	case LabelA:
+		// i.e. lit <-> (p(c1) v p(c2))
+		return itp.Or(pc1, pc2);
+	case LabelB:
+		// i.e. lit <-> (p(c1) ^ p(c2))
+		return itp.And(pc1, pc2);
+	case LabelAB: {
+		// i.e. lit <-> ((v v p(c1)) ^ (~v v p(c2))) where v occurs
+		// positively in c1.
+		const auto pos = std::binary_search(c1.cbegin(), c1.cend(), Lit(v, false));
+		const auto x = itp.leaf(Lit(v, !pos));
+		return itp.And(itp.Or(x, pc1), itp.Or(~x, pc2));
+	}
+	}
+
+	throw std::domain_error("unknown label");
+}
+
+auto Vertex::assignLit(ItpContext &ctx) -> Lit
+{
+	auto &itp = ctx.itp;
+
+	if (freed) {
+		throw std::logic_error("proof: chain on a freed clause");
+	}
+
+	if (referenced) {
+		return lit;
+	}
+
+	if (type == VertexRoot) {
+		lit = rootItp(ctx, c, part);
+		referenced = true;
+	}else if(type == VertexChain) {
+		const auto xssz = xs.size();
+		// only Pudlak's system needs to know the phase of the pivots.
+		const auto needClause = ctx.system == ItpSystem::Pudlak;
+
+		auto &first = ctx.proof[cs[0]];
+		lit = first.assignLit(ctx);
+		if (needClause)
+			first.c.copyTo(c);
+
+		for(auto i = 0; i < xssz; i++) {
+			auto &next = ctx.proof[cs[i+1]];
+			const auto v = xs[i]; // pivot variable
+
+			const auto pc2 = next.assignLit(ctx);
+			lit = resolventItp(ctx, c, lit, pc2, v);
+
+			if (needClause)
+				resolve(c, next.c, v);
+		}
+
+		referenced = true;
+	}else{
+		throw std::domain_error("type of vertex: neither root nor chain");
+	}
+
+	assert(referenced);
+
+	return lit;
+}
+
+ItpTraverser::ItpTraverser(ItpContext &ctx, std::function<int(ClauseId)> partOf)
+    : ctx(ctx), partOf(std::move(partOf))
+{
+}
+
+void ItpTraverser::root(const vec<Lit> &c)
+{
+	lits.push_back(rootItp(ctx, c, partOf(lits.size())));
+	if (ctx.system == ItpSystem::Pudlak)
+		clauses.emplace(lits.size() - 1, c);
+}
+
+void ItpTraverser::chain(const vec<ClauseId> &cs, const vec<Var> &xs)
+{
+	const auto needClause = ctx.system == ItpSystem::Pudlak;
+	vec<Lit> c;
+
+	auto lit = lits[cs[0]];
+	if (needClause)
+		clauses.at(cs[0]).copyTo(c);
+
+	for(auto i = 0; i < xs.size(); i++) {
+		lit = resolventItp(ctx, c, lit, lits[cs[i+1]], xs[i]);
+		if (needClause)
+			resolve(c, clauses.at(cs[i+1]), xs[i]);
+	}
+
+	lits.push_back(lit);
+	if (needClause)
+		clauses.emplace(lits.size() - 1, std::move(c));
+}
+
+void ItpTraverser::deleted(ClauseId c)
+{
+	clauses.erase(c);
+}
+
+auto ItpTraverser::result() const -> Lit
+{
+	return lits.back();
+}
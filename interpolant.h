@@ -0,0 +1,103 @@
+#pragma once
+
+#include "MiniSat-p_v1.14/Solver.h"
+#include "circuit.h"
+#include "cnfer.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ItpSystem selects the labeled interpolation system that is used to compute
+// interpolants from refutations. The systems differ in the label given to
+// the variables shared by A and B, which changes the strength of the
+// interpolant: McMillan's system gives the strongest interpolants, the inverse
+// McMillan system the weakest, Pudlak's (symmetric) system lies in between.
+enum class ItpSystem { McMillan, Pudlak, InverseMcMillan };
+
+// parseItpSystem converts "mcmillan", "pudlak" or "inverse" to an ItpSystem.
+// It throws std::invalid_argument for other names.
+auto parseItpSystem(const std::string &name) -> ItpSystem;
+
+extern const char VertexRoot[];
+extern const char VertexChain[];
+
+struct Vertex;
+
+// ItpPartitions records the first and the last partition every variable occurs
+// in. The clauses are split into a sequence of partitions; for a cut c, the
+// partitions up to and including c form A, the remaining ones form B.
+class ItpPartitions {
+	std::vector<int> first, last;
+
+public:
+	// add records the variables of the clauses as occurring in partition part.
+	void add(const VecCNFer &clauses, int part);
+
+	// inA checks whether the variable occurs in A for the given cut.
+	auto inA(Var v, int cut) const -> bool;
+
+	// inB checks whether the variable occurs in B for the given cut.
+	auto inB(Var v, int cut) const -> bool;
+};
+
+// ItpContext holds everything that is needed to label a refutation: the
+// partitions and the cut between A and B, the labeling system, the refutation
+// DAG and the circuit that receives the interpolant.
+struct ItpContext {
+	const ItpPartitions &parts;
+	int cut;
+	ItpSystem system;
+	Vertex *proof;
+	Circuit &itp;
+};
+
+// Vertex is a node of a refutation DAG as reported by a ProofTraverser.
+struct Vertex {
+	const char *type = nullptr; // VertexRoot or VertexChain
+
+	vec<Lit> c; // the clause of a root (for Pudlak's system also of a chain)
+	vec<ClauseId> cs;
+	vec<Var> xs;
+	int part; // the partition a root belongs to
+
+	Lit lit; // lit is the circuit node of the partial interpolant p(c) if referenced == true
+
+	bool referenced = false; // lit is populated
+	bool deleted = false; // deleted was called on the vertex.
+	int uses = 0; // the number of chains the vertex is an antecedent of
+	bool freed = false; // c, cs and xs were dropped: it is deleted and unused
+
+	Vertex() {}
+
+	Vertex(const char *type) : type(type) {}
+
+	// assignLit computes the partial interpolant of the vertex (and recursively
+	// of the vertices it is derived from) and returns its circuit node. Reset
+	// `referenced` on all vertices before using a different context.
+	auto assignLit(ItpContext &ctx) -> Lit;
+};
+
+// ItpTraverser computes an interpolant while a proof is replayed to it (e.g. by
+// Proof::traverse on a compressed offline proof), so the refutation DAG never
+// has to be kept in memory. Only the partial interpolant of every clause is
+// stored; the clauses themselves are kept for Pudlak's system only, until the
+// proof reports them as deleted. partOf maps a clause ID of the replayed proof
+// to the partition of the root. ctx.proof is not used.
+class ItpTraverser : public ProofTraverser {
+	ItpContext &ctx;
+	std::function<int(ClauseId)> partOf;
+	std::vector<Lit> lits;
+	std::unordered_map<ClauseId, vec<Lit>> clauses;
+
+public:
+	ItpTraverser(ItpContext &ctx, std::function<int(ClauseId)> partOf);
+
+	void root(const vec<Lit> &c) override;
+	void chain(const vec<ClauseId> &cs, const vec<Var> &xs) override;
+	void deleted(ClauseId c) override;
+
+	// result returns the partial interpolant of the last clause of the proof.
+	auto result() const -> Lit;
+};
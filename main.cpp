@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <string>
 
+#include <csignal>
 #include <cstring>
 #include <getopt.h>
 
@@ -17,6 +20,26 @@ struct Env {
 	bool ShowProof = false;
 	bool PrintDIMACS = false;
 	bool Interpolation = false;
+	bool InterpolationSequence = false;
+	bool MinimizeInterpolants = true;
+	ItpSystem InterpolationSystem = ItpSystem::McMillan;
+	bool OfflineProofs = false;
+	int Restarts = -1; // a RestartPolicy, -1 for the model checker's default
+	int PhaseSaving = -1; // 0 or 1, -1 for the model checker's default
+	bool VariableElimination = true;
+	long long ConflictLimit = -1;
+	double DepthTimeLimit = -1;
+	int ParallelWorkers = 1;
+	int CubeDepth = 0;
+	bool LatchAliasing = false;
+	bool DepthScheduling = false;
+	bool LearntTransfer = false;
+	bool ExactDepth = false;
+	BmcDirection Direction = BmcDirection::Forward;
+	bool Abstraction = false;
+	int EnlargeSteps = 0;
+	DepthScheduler::Order DepthOrder = DepthScheduler::Interleaved;
+	std::string StatsFile; // empty for no statistics, "-" for stdout
 };
 
 const char USAGE[] =
@@ -26,6 +49,33 @@ const char USAGE[] =
     "-k <steps>             # of steps the model checker will unwind (default k=0)\n"
     "-f <file path>         read from a file instead of console\n"
     "-p | --proof           show proof\n"
+    "-i | --interpolate     use interpolation based unbounded model checking\n"
+    "--itp-seq              use interpolation sequence based unbounded model checking\n"
+    "--no-itp-min           do not simplify interpolants between iterations\n"
+    "--itp-system <name>    interpolation system: mcmillan (default), pudlak or inverse\n"
+    "                       (--itp-seq only supports mcmillan)\n"
+    "--offline-proof        log proofs to temporary files instead of memory\n"
+    "--restarts <name>      SAT solver restarts: geometric, luby or glucose (default)\n"
+    "--[no-]phase-saving    turn phase saving of the SAT solver on (default) or off\n"
+    "--no-elim              do not preprocess the BMC formula by variable elimination\n"
+    "--conflict-limit <n>   give up a SAT call after n conflicts\n"
+    "--depth-timeout <sec>  give up after sec seconds on one BMC depth\n"
+    "--latch-alias          encode latch outputs as their next-state functions in BMC\n"
+    "-j | --parallel <n>    solve the classical BMC check with n clause-sharing solvers\n"
+    "--exact-depth          check the BMC depths one by one on an incremental solver,\n"
+    "                       excluding the bad states of the refuted depths\n"
+    "--direction <name>     unroll BMC depth by depth forward (default), backward from\n"
+    "                       the bad states or from both ends (both)\n"
+    "--abstract             check the BMC depths one by one on a latch abstraction that\n"
+    "                       is refined by spurious counterexamples\n"
+    "--enlarge <steps>      add the states that reach a bad state in up to steps steps\n"
+    "                       to the bad states, so that BMC needs fewer steps\n"
+    "--transfer-learnts     check the BMC depths one by one, carrying short learnt\n"
+    "                       clauses over to the next depth\n"
+    "--cubes <depth>        split the classical BMC check into cubes of depth variables\n"
+    "--schedule <order>     check the BMC depths separately on the -j workers, handed\n"
+    "                       out one by one (interleaved) or in doubling ranges (geometric)\n"
+    "--stats <file>         write per-phase statistics as JSON to file (- for stdout)\n"
     "--parse-only           Only parse ASCII AIGer file (for testing)\n";
 
 auto usage(const char *prog) -> void
@@ -33,6 +83,54 @@ auto usage(const char *prog) -> void
 	std::cout << "Usage: " << prog << USAGE << std::endl;
 }
 
+// checkEngine exits with a usage error if the options choose more than one
+// model checking engine, or an option the chosen engine does not support.
+static auto checkEngine(const char *prog, const Env &e) -> void
+{
+	struct Engine {
+		const char *option;
+		bool chosen;
+		bool aliasing; // supports --latch-alias
+		bool parallel; // supports -j
+	};
+	const Engine engines[] = {
+	    {"--interpolate", e.Interpolation && !e.InterpolationSequence, false, false},
+	    {"--itp-seq", e.InterpolationSequence, false, false},
+	    {"--cubes", e.CubeDepth > 0, true, true},
+	    {"--schedule", e.DepthScheduling, true, true},
+	    {"--transfer-learnts", e.LearntTransfer, false, false},
+	    {"--exact-depth", e.ExactDepth, true, false},
+	    {"--direction", e.Direction != BmcDirection::Forward, false, false},
+	    {"--abstract", e.Abstraction, false, false},
+	};
+
+	const auto fail = [&](const std::string &message) {
+		usage(prog);
+		std::cout << "error: " << message << std::endl;
+		exit(1);
+	};
+
+	// without any of them, the classical BMC check supports everything.
+	const Engine *chosen = nullptr;
+	for (const auto &engine : engines) {
+		if (!engine.chosen)
+			continue;
+		if (chosen != nullptr)
+			fail(std::string(chosen->option) + " cannot be combined with " + engine.option);
+		chosen = &engine;
+	}
+	if (chosen == nullptr)
+		return;
+
+	// the interpolants of a sequence are only inductive in McMillan's system.
+	if (e.InterpolationSequence && e.InterpolationSystem != ItpSystem::McMillan)
+		fail("--itp-seq only supports --itp-system mcmillan");
+	if (e.LatchAliasing && !chosen->aliasing)
+		fail(std::string("--latch-alias cannot be combined with ") + chosen->option);
+	if (e.ParallelWorkers > 1 && !chosen->parallel)
+		fail(std::string("-j cannot be combined with ") + chosen->option);
+}
+
 auto parseArgs(int argc, char **argv) -> Env
 {
 	static option long_options[] = {{"parse-only", no_argument, 0, 0},
@@ -40,12 +138,32 @@ auto parseArgs(int argc, char **argv) -> Env
 					{"dimacs", no_argument, 0, 0},
 					{"proof", no_argument, 0, 'p'},
 					{"interpolate", no_argument, 0, 'i'},
+					{"no-itp-min", no_argument, 0, 0},
+					{"itp-system", required_argument, 0, 0},
+					{"itp-seq", no_argument, 0, 0},
+					{"offline-proof", no_argument, 0, 0},
+					{"restarts", required_argument, 0, 0},
+					{"phase-saving", no_argument, 0, 0},
+					{"no-phase-saving", no_argument, 0, 0},
+					{"no-elim", no_argument, 0, 0},
+					{"conflict-limit", required_argument, 0, 0},
+					{"depth-timeout", required_argument, 0, 0},
+					{"stats", required_argument, 0, 0},
+					{"parallel", required_argument, 0, 'j'},
+					{"cubes", required_argument, 0, 0},
+					{"latch-alias", no_argument, 0, 0},
+					{"schedule", required_argument, 0, 0},
+					{"transfer-learnts", no_argument, 0, 0},
+					{"exact-depth", no_argument, 0, 0},
+					{"direction", required_argument, 0, 0},
+					{"abstract", no_argument, 0, 0},
+					{"enlarge", required_argument, 0, 0},
 					{0, 0, 0, 0}};
 	Env e;
 	while (1) {
 		int option_index = 0, c;
 
-		c = getopt_long(argc, argv, "d::f:ik:p", long_options, &option_index);
+		c = getopt_long(argc, argv, "d::f:ij:k:p", long_options, &option_index);
 		if (c == -1)
 			break;
 
@@ -63,6 +181,104 @@ auto parseArgs(int argc, char **argv) -> Env
 			e.PrintDIMACS = true;
 			break;
 
+		case 5: // --no-itp-min
+			e.MinimizeInterpolants = false;
+			break;
+
+		case 6: // --itp-system
+			try {
+				e.InterpolationSystem = parseItpSystem(optarg);
+			} catch (std::invalid_argument &err) {
+				std::cout << "error: " << err.what() << std::endl;
+				exit(1);
+			}
+			break;
+
+		case 7: // --itp-seq
+			e.Interpolation = true;
+			e.InterpolationSequence = true;
+			break;
+
+		case 8: // --offline-proof
+			e.OfflineProofs = true;
+			break;
+
+		case 9: // --restarts
+			try {
+				e.Restarts = parseRestartPolicy(optarg);
+			} catch (std::invalid_argument &err) {
+				std::cout << "error: " << err.what() << std::endl;
+				exit(1);
+			}
+			break;
+
+		case 10: // --phase-saving
+			e.PhaseSaving = 1;
+			break;
+
+		case 11: // --no-phase-saving
+			e.PhaseSaving = 0;
+			break;
+
+		case 12: // --no-elim
+			e.VariableElimination = false;
+			break;
+
+		case 13: // --conflict-limit
+			e.ConflictLimit = atoll(optarg);
+			break;
+
+		case 14: // --depth-timeout
+			e.DepthTimeLimit = atof(optarg);
+			break;
+
+		case 15: // --stats
+			e.StatsFile = optarg;
+			break;
+
+		case 17: // --cubes
+			e.CubeDepth = std::max(atoi(optarg), 0);
+			break;
+
+		case 18: // --latch-alias
+			e.LatchAliasing = true;
+			break;
+
+		case 19: // --schedule
+			try {
+				e.DepthOrder = parseDepthOrder(optarg);
+				e.DepthScheduling = true;
+			} catch (std::invalid_argument &err) {
+				std::cout << "error: " << err.what() << std::endl;
+				exit(1);
+			}
+			break;
+
+		case 20: // --transfer-learnts
+			e.LearntTransfer = true;
+			break;
+
+		case 21: // --exact-depth
+			e.ExactDepth = true;
+			break;
+
+		case 22: // --direction
+			try {
+				e.Direction = parseBmcDirection(optarg);
+			} catch (std::invalid_argument &err) {
+				std::cout << "error: " << err.what() << std::endl;
+				exit(1);
+			}
+			break;
+
+		case 23: // --abstract
+			e.Abstraction = true;
+			break;
+
+		case 24: // --enlarge
+			e.EnlargeSteps = std::max(atoi(optarg), 0);
+			break;
+
 		case 'd':
 			if (optarg == nullptr) {
 				e.Debug = 1;
@@ -79,6 +295,10 @@ auto parseArgs(int argc, char **argv) -> Env
 			e.Interpolation = true;
 			break;
 
+		case 'j':
+			e.ParallelWorkers = std::max(atoi(optarg), 1);
+			break;
+
 		case 'k':
 			e.K = atoi(optarg);
 			break;
@@ -111,25 +331,80 @@ auto parseArgs(int argc, char **argv) -> Env
 		exit(0);
 	}
 
+	checkEngine(argv[0], e);
+
 	return e;
 }
 
+// running is the model checker that is stopped by SIGINT.
+static AIGtoSATer *running = nullptr;
+
+static void onInterrupt(int)
+{
+	// a second SIGINT terminates as usual.
+	std::signal(SIGINT, SIG_DFL);
+	if (running != nullptr)
+		running->interrupt();
+}
+
+// writeStats writes stats to the file given by --stats.
+static auto writeStats(const Env &env, const Stats &stats) -> void
+{
+	if (env.StatsFile == "-") {
+		stats.writeJSON(std::cout);
+		return;
+	}
+
+	std::ofstream file(env.StatsFile);
+	stats.writeJSON(file);
+	if (file.fail()) {
+		std::cout << "error: cannot write statistics to '" << env.StatsFile << "'" << std::endl;
+	}
+}
+
 auto main(int argc, char **argv) -> int
 {
 	auto env = parseArgs(argc, argv);
+	Stats stats;
+
+	Stats::Phase parse(env.StatsFile.empty() ? nullptr : &stats, "parse");
 	auto aig = AIG::FromStream(*env.inputstream);
+	parse.set("inputs", int(aig.inputs.size()));
+	parse.set("latches", int(aig.latches.size()));
+	parse.set("ands", int(aig.gates.size()));
+	parse.set("constraints", int(aig.constraints.size()));
+	parse.done();
 
 	if (env.ParserTest) {
 		return 0;
 	}
 
-	if (aig.outputs.size() == 0) {
+	if (aig.Properties().empty()) {
 		std::cout << "Model has no outputs. Bad states cannot be detected." << std::endl;
 		std::cout << "Exiting." << std::endl;
 		return 0;
 	}
 
+	// a single bad state property is checked like a single output by all
+	// engines.
+	if (aig.outputs.empty() && aig.bads.size() == 1) {
+		aig.outputs.swap(aig.bads);
+	}
+
+	// several properties are checked by one depth-by-depth BMC engine.
+	const auto engine = env.Interpolation || env.Abstraction || env.Direction != BmcDirection::Forward ||
+	                    env.LearntTransfer || env.DepthScheduling || env.CubeDepth > 0;
+	if (aig.Properties().size() > 1 && (engine || env.ParallelWorkers > 1 || env.EnlargeSteps > 0)) {
+		std::cout << "error: a model with several properties is only checked by BMC depth by depth,"
+		          << " which supports --exact-depth and --latch-alias" << std::endl;
+		return 1;
+	}
+
 	std::cout << "outputs " << aig.outputs.size() << std::endl;
+	if (!aig.bads.empty())
+		std::cout << "bad states " << aig.bads.size() << std::endl;
+	if (!aig.constraints.empty())
+		std::cout << "constraints " << aig.constraints.size() << std::endl;
 	std::cout << "K = " << env.K << std::endl;
 
 	try {
@@ -142,19 +417,71 @@ auto main(int argc, char **argv) -> int
 			DimacsCNFer cnfer(std::cout);
 			AIGtoSATer ats{aig};
 			VarTranslator vars(&cnfer, aig.lastLit, env.K);
+			if(env.LatchAliasing)
+				vars.aliasLatches(aig.latches);
 			ats.toSAT(cnfer, vars, env.K);
 			return 0;
 		}
 
-		AIGtoSATer ats{aig};
+		// the checks of an enlarged target need that many fewer steps.
+		EnlargedTarget target;
+		const AIG *model = &aig;
+		if(env.EnlargeSteps > 0) {
+			Stats::Phase enlarge(env.StatsFile.empty() ? nullptr : &stats, "enlarge");
+			const auto steps = env.K >= 0 ? std::min(env.EnlargeSteps, env.K) : env.EnlargeSteps;
+			target = AIGtoSATer{aig}.enlargeTarget(steps);
+			enlarge.set("steps", target.steps);
+			enlarge.set("cubes", target.cubes);
+			std::cout << "target enlarged by " << target.steps << " steps with "
+				  << target.cubes << " cubes" << std::endl;
+			model = &target.aig;
+		}
+
+		AIGtoSATer ats{*model};
+		ats.setDepthOffset(target.steps);
 
 		if(env.Interpolation)
 			ats.enableInterpolation();
-		
-		auto result = ats.check(env.K);
-		assert(result == AIGtoSATer::OK || result == AIGtoSATer::FAIL);
+		if(env.InterpolationSequence)
+			ats.enableInterpolationSequence();
+		ats.setInterpolantMinimization(env.MinimizeInterpolants);
+		ats.setInterpolationSystem(env.InterpolationSystem);
+		if(env.OfflineProofs)
+			ats.enableOfflineProofs();
+		if(env.Restarts != -1)
+			ats.setRestartPolicy(RestartPolicy(env.Restarts));
+		if(env.PhaseSaving != -1)
+			ats.setPhaseSaving(env.PhaseSaving);
+		ats.setVariableElimination(env.VariableElimination);
+		ats.setConflictLimit(env.ConflictLimit);
+		ats.setDepthTimeLimit(env.DepthTimeLimit);
+		ats.setParallelWorkers(env.ParallelWorkers);
+		ats.setCubeDepth(env.CubeDepth);
+		ats.setLatchAliasing(env.LatchAliasing);
+		ats.setExactDepth(env.ExactDepth);
+		ats.setDirection(env.Direction);
+		ats.setAbstraction(env.Abstraction);
+		ats.setLearntTransfer(env.LearntTransfer);
+		if(env.DepthScheduling)
+			ats.setDepthScheduling(env.DepthOrder);
+		if(!env.StatsFile.empty())
+			ats.setStats(&stats);
+
+		running = &ats;
+		std::signal(SIGINT, onInterrupt);
+		auto result = ats.check(env.K < 0 ? env.K : env.K - target.steps);
+		std::signal(SIGINT, SIG_DFL);
+		running = nullptr;
+		assert(result == AIGtoSATer::OK || result == AIGtoSATer::FAIL || result == AIGtoSATer::UNDECIDED);
 
-		std::cout << std::endl << (result == AIGtoSATer::FAIL ? "FAIL" : "OK") << std::endl;
+		const auto name = result == AIGtoSATer::FAIL ? "FAIL" : result == AIGtoSATer::OK ? "OK" : "UNDECIDED";
+		std::cout << std::endl << name << std::endl;
+
+		if(!env.StatsFile.empty()) {
+			stats.set("result", name);
+			stats.set("k", env.K);
+			writeStats(env, stats);
+		}
 
 	}catch(TranslationError& err) {
 		std::cout << "translation error: " << err.what() << std::endl << std::endl;
@@ -0,0 +1,97 @@
+#include "portfolio.h"
+#include "MiniSat-p_v1.14/Sharing.h"
+#include "MiniSat-p_v1.14/SimpSolver.h"
+#include "workers.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// diversify returns the search parameters of worker i.
+static auto diversify(SearchParams params, int i) -> SearchParams
+{
+	static const RestartPolicy restarts[] = {restart_Glucose, restart_Luby, restart_Geometric};
+	static const double randomVarFreq[] = {0.02, 0.05, 0.0, 0.1};
+
+	if (i == 0)
+		return params;
+
+	params.restarts = restarts[i % 3];
+	params.random_var_freq = randomVarFreq[i % 4];
+	params.phase_saving = i % 4 != 2;
+	return params;
+}
+
+Portfolio::Portfolio(int workers, const SearchParams &params) : workers(workers), params(params)
+{
+	assert(workers > 0);
+}
+
+void Portfolio::setVariableElimination(bool yes)
+{
+	variableElimination = yes;
+}
+
+auto Portfolio::solve(const VecCNFer &cnf, const std::function<void(Solver &)> &prepare) -> lbool
+{
+	SharedClauses sharing(workers);
+	std::atomic<bool> stop{false};
+	std::atomic<bool> *outer = nullptr;
+
+	// every worker gets its own copy of the clauses. The variable
+	// elimination does not depend on the search parameters, so all workers
+	// eliminate the same variables and can exchange clauses.
+	std::vector<std::unique_ptr<SimpSolver>> solvers;
+	for (auto i = 0; i != workers; i++) {
+		solvers.push_back(std::make_unique<SimpSolver>());
+		auto &s = *solvers.back();
+		s.default_params = diversify(params, i);
+		s.setRandomSeed(91648253 + i);
+		s.use_elim = variableElimination;
+
+		SolverCNFer scnfer{s};
+		cnf.copyTo(scnfer);
+
+		prepare(s);
+		outer = s.interrupt_flag;
+		s.interrupt_flag = &stop;
+		s.sharing = &sharing;
+		s.sharing_id = i;
+	}
+
+	std::mutex m;
+	auto result = l_Undef;
+	decidedBy = -1;
+
+	// no assumptions: clauses are only imported at decision level 0.
+	const auto search = [&](int i) {
+		vec<Lit> none;
+		const auto r = solvers[i]->solveLimited(none);
+
+		std::lock_guard<std::mutex> lock(m);
+		if (r != l_Undef && result == l_Undef) {
+			result = r;
+			decidedBy = i;
+			stop.store(true);
+		}
+	};
+	runWorkers(workers, search, *outer, [&] { stop.store(true); });
+
+	imported = 0;
+	for (const auto &s : solvers) {
+		imported += s->stats.imported;
+	}
+
+	return result;
+}
+
+auto Portfolio::winner() const -> int
+{
+	return decidedBy;
+}
+
+auto Portfolio::importedClauses() const -> int64_t
+{
+	return imported;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "MiniSat-p_v1.14/Solver.h"
+#include "cnfer.h"
+
+#include <functional>
+
+// Portfolio solves a single CNF with several diversified solvers running in
+// parallel threads. The solvers share short or low-LBD learnt clauses, and
+// the first one to finish decides. No proofs are logged.
+class Portfolio {
+	int workers;
+	SearchParams params;
+	bool variableElimination = true;
+	int decidedBy = -1;
+	int64_t imported = 0;
+
+public:
+	// Worker 0 searches with params, the others vary the restart policy, phase
+	// saving, the random decision frequency and the random seed.
+	Portfolio(int workers, const SearchParams &params);
+
+	// setVariableElimination turns preprocessing in every worker on or off.
+	// It is turned on by default.
+	void setVariableElimination(bool yes);
+
+	// solve solves cnf. prepare is called for every worker before it starts,
+	// e.g. to set a budget. Setting the interrupt flag that prepare leaves in
+	// a worker stops all of them. l_Undef is returned if every worker ran out
+	// of its budget or the workers were interrupted.
+	auto solve(const VecCNFer &cnf, const std::function<void(Solver &)> &prepare) -> lbool;
+
+	// winner returns the worker that decided the last solve(), or -1.
+	auto winner() const -> int;
+
+	// importedClauses returns the number of clauses the workers imported from
+	// each other in the last solve().
+	auto importedClauses() const -> int64_t;
+};
@@ -0,0 +1,122 @@
+#include "translate.h"
+
+#include <algorithm>
+#include <iomanip>
+
+auto AIGtoSATer::multiPropertyMC(int k) const -> Result
+{
+	if (interpolation || interpolationSequence) {
+		throw ErrOutputNotSingular;
+	}
+
+	// Property is the state of one output or bad state property.
+	struct Property {
+		std::string name;
+		int lit;
+		Result result = UNDECIDED;
+		int depth = -1; // of the counterexample, the proof or the last safe depth
+		bool proven = false;
+	};
+	std::vector<Property> properties;
+	for (size_t i = 0; i != aig.outputs.size(); i++) {
+		properties.push_back({"o" + std::to_string(i), aig.outputs[i]});
+	}
+	for (size_t i = 0; i != aig.bads.size(); i++) {
+		properties.push_back({"b" + std::to_string(i), aig.bads[i]});
+	}
+
+	// the initial state is only required under init, so that a refutation
+	// without it holds from any state.
+	Solver s;
+	s.default_params = searchParams;
+	SolverCNFer scnfer{s};
+	VarTranslator vars{&scnfer, aig.lastLit/2, k};
+	if (latchAliasing)
+		vars.aliasLatches(aig.latches);
+	const auto init = Lit(s.newVar());
+	I(scnfer, vars, init);
+
+	// the depths are not stopped by a failing property, so they have a loop
+	// and a report line of their own.
+	auto open = properties.size();
+	for (auto d = 0; d <= k && open != 0; d++) {
+		startDepth();
+		DepthCheck depth(stats, d);
+		if (d > 0) {
+			T(scnfer, vars, d - 1);
+			C(scnfer, vars, d);
+		}
+
+		auto failed = 0, proven = 0;
+		for (auto &p : properties) {
+			if (p.result != UNDECIDED || p.depth != d - 1)
+				continue;
+
+			// every property asks for its bad state under its own act.
+			const auto bad = vars.toLit(p.lit, d);
+			const auto act = Lit(s.newVar());
+			s.addBinary(bad, ~act);
+
+			// init is assumed last, so that the refutation does without it
+			// if propagation does.
+			const auto sat = solveDepth(s, {vars.True(), act, init}, depth);
+			s.addUnit(~act);
+			if (sat == l_Undef) {
+				open--;
+				continue;
+			}
+
+			p.depth = d;
+			if (sat == l_True) {
+				p.result = FAIL;
+				failed++;
+				open--;
+				continue;
+			}
+
+			// a bad state that no state reaches in d steps is not reached
+			// in more steps either.
+			p.proven = std::find(s.conflict.begin(), s.conflict.end(), ~init) == s.conflict.end();
+			s.addBinary(~init, ~bad);
+			if (p.proven) {
+				p.result = OK;
+				proven++;
+				open--;
+			}
+		}
+
+		std::cout << "depth " << d << ": " << failed << " failed, " << proven << " proven, " << open
+		          << " open, " << depth.conflicts << " conflicts" << std::endl;
+		depth.phase.set("failed", failed);
+		depth.phase.set("proven", proven);
+		depth.phase.set("open", int(open));
+	}
+
+	// the properties left open hold up to k.
+	auto result = OK;
+	std::cout << std::endl << "property  literal  result     depth" << std::endl;
+	for (auto &p : properties) {
+		if (p.result == UNDECIDED && p.depth == k)
+			p.result = OK;
+
+		std::string depth;
+		if (p.result == FAIL)
+			depth = std::to_string(p.depth + depthOffset);
+		else if (p.proven)
+			depth = "proven at " + std::to_string(p.depth + depthOffset);
+		else if (p.depth >= 0)
+			depth = "up to " + std::to_string(p.depth + depthOffset);
+
+		const auto name = p.result == FAIL ? "FAIL" : p.result == OK ? "OK" : "UNDECIDED";
+		std::cout << std::left << std::setw(10) << p.name << std::setw(9) << p.lit << std::setw(11) << name
+		          << depth << std::endl;
+
+		if (p.result == FAIL)
+			result = FAIL;
+		else if (p.result == UNDECIDED && result == OK)
+			result = UNDECIDED;
+	}
+	std::cout << std::right;
+
+	return result;
+}
@@ -0,0 +1,96 @@
+#include "translate.h"
+
+auto AIGtoSATer::scheduledMC(int k) const -> Result
+{
+	if (aig.outputs.size() != 1) {
+		throw ErrOutputNotSingular;
+	}
+
+	Stats::Phase bmc(stats, "bmc", k);
+
+	// every worker unrolls its own solver as far as its deepest job so far.
+	// All depths up to k are reserved, so the unrolling only ever grows.
+	struct Unrolling {
+		Solver s;
+		SolverCNFer cnf{s};
+		VarTranslator vars;
+		int steps = 0;
+		std::vector<Lit> ok; // ok[d] implies the constraints of the steps 1..d
+	};
+	std::vector<std::unique_ptr<Unrolling>> unrollings(parallelWorkers);
+
+	const auto check = [&](int worker, int first, int last, std::atomic<bool> &cancel) {
+		auto &u = unrollings[worker];
+		if (!u) {
+			u = std::make_unique<Unrolling>();
+			u->s.default_params = searchParams;
+			u->vars.reset(&u->cnf, aig.lastLit/2, k);
+			if (latchAliasing)
+				u->vars.aliasLatches(aig.latches);
+			I(u->cnf, u->vars);
+			u->ok.push_back(u->vars.True());
+		}
+		for (; u->steps < last; u->steps++) {
+			T(u->cnf, u->vars, u->steps);
+			u->ok.push_back(constrained(u->cnf, u->vars, u->ok.back(), u->steps + 1));
+		}
+
+		// the bad states of the job and the constraints up to its first
+		// depth are only required under an activation literal, which is
+		// turned off for good afterwards. The unrolling may be deeper than
+		// the job, so the constraints only count up to the bad state.
+		const auto act = Lit(u->s.newVar());
+		if (u->ok[first] != u->vars.True())
+			u->s.addBinary(~act, u->ok[first]);
+		F(u->cnf, u->vars, first, last, act);
+
+		// every job is a depth of its own and gets the whole time limit.
+		// The scheduler cancels the job also on interrupt().
+		applyBudget(u->s, depthDeadlineFromNow());
+		u->s.interrupt_flag = &cancel;
+		const auto sat = u->s.solveLimited({u->vars.True(), act});
+		u->s.addUnit(~act);
+		return sat;
+	};
+
+	DepthScheduler scheduler(parallelWorkers, depthOrder);
+	const auto sat = scheduler.run(k, check, interrupted);
+
+	const auto &jobs = scheduler.jobs();
+	for (size_t i = 0; i != jobs.size(); i++) {
+		const auto &job = jobs[i];
+		if (job.worker == -1)
+			continue;
+
+		if (job.first == job.last)
+			std::cout << "depth " << job.first << ": ";
+		else
+			std::cout << "depths " << job.first << "-" << job.last << ": ";
+		std::cout << (job.result == l_True ? "SAT" : job.result == l_False ? "UNSAT" : job.cancelled ? "cancelled" : "undecided")
+		          << " by solver " << job.worker << ", " << job.seconds << " s" << std::endl;
+
+		Stats::Phase phase(stats, "job", job.first, i);
+		phase.set("last", job.last);
+		phase.set("worker", job.worker);
+		phase.set("result", job.cancelled ? "cancelled" : satName(job.result));
+		phase.done(job.seconds);
+	}
+
+	const auto failure = scheduler.firstFailure();
+	const auto safe = scheduler.safeDepth();
+	bmc.set("workers", parallelWorkers);
+	bmc.set("jobs", int(jobs.size()));
+	bmc.set("result", satName(sat));
+	bmc.set("first_failure", failure);
+	if (sat == l_True) {
+		if (failure >= 0)
+			reportShortest(failure);
+		else
+			std::cout << "counterexample found, no counterexample up to depth " << safe << std::endl;
+		return FAIL;
+	}
+	if (sat == l_Undef) {
+		return undecided(k, safe);
+	}
+	return OK;
+}
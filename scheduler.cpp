@@ -0,0 +1,164 @@
+#include "scheduler.h"
+#include "workers.h"
+
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+DepthScheduler::DepthScheduler(int workers, Order order) : workers(workers), order(order)
+{
+	assert(workers > 0);
+}
+
+auto DepthScheduler::run(int k, const Check &check, const std::atomic<bool> &interrupt) -> lbool
+{
+	jobList.clear();
+	depths.assign(k + 1, Unknown);
+
+	std::deque<size_t> pending;
+	auto add = [&](int first, int last) {
+		jobList.push_back(Job{first, last});
+		return jobList.size() - 1;
+	};
+	if (order == Interleaved) {
+		for (auto d = 0; d <= k; d++) {
+			pending.push_back(add(d, d));
+		}
+	} else {
+		pending.push_back(add(0, 0));
+		for (auto d = 1; d <= k; d *= 2) {
+			pending.push_back(add(d, std::min(2 * d - 1, k)));
+		}
+	}
+
+	std::unique_ptr<std::atomic<bool>[]> cancel(new std::atomic<bool>[workers]);
+	std::vector<size_t> current(workers, SIZE_MAX); // the job of every worker
+	for (auto i = 0; i != workers; i++) {
+		cancel[i].store(false);
+	}
+
+	// jobs starting at or above bound are not needed: a counterexample of
+	// at most bound steps is known, and depth bound fails unless a shallower
+	// one does.
+	auto bound = INT_MAX;
+	auto stopped = false;
+	auto satisfiable = false;
+	std::mutex m;
+	std::condition_variable work;
+	auto busy = 0;
+
+	// record stores the result of job n and cancels the jobs it makes
+	// unnecessary. m must be held.
+	auto record = [&](size_t n, lbool r) {
+		// add() may move the jobs, so no reference into jobList is kept.
+		jobList[n].result = r;
+		const auto first = jobList[n].first, last = jobList[n].last;
+		if (r == l_False) {
+			for (auto d = first; d <= last; d++) {
+				depths[d] = Safe;
+			}
+			return;
+		}
+		if (r != l_True)
+			return;
+
+		satisfiable = true;
+		if (depths[last] != Safe)
+			depths[last] = first == last ? Fail : FailUnlessShorter;
+		bound = std::min(bound, last);
+
+		// the failing depth of a range is searched among its shorter depths
+		// before anything else.
+		for (auto d = last - 1; d >= first; d--) {
+			pending.push_front(add(d, d));
+		}
+		for (auto i = 0; i != workers; i++) {
+			if (current[i] != SIZE_MAX && jobList[current[i]].first >= bound)
+				cancel[i].store(true);
+		}
+	};
+
+	// idle workers take the next pending job.
+	const auto runJobs = [&](int i) {
+		std::unique_lock<std::mutex> lock(m);
+		while (true) {
+			// a running range may still be split into more jobs.
+			work.wait(lock, [&] { return stopped || !pending.empty() || busy == 0; });
+			if (stopped || pending.empty())
+				break;
+
+			const auto n = pending.front();
+			pending.pop_front();
+			if (jobList[n].first >= bound)
+				continue;
+
+			const auto first = jobList[n].first, last = jobList[n].last;
+			jobList[n].worker = i;
+			current[i] = n;
+			busy++;
+			cancel[i].store(false);
+			lock.unlock();
+
+			const auto start = std::chrono::steady_clock::now();
+			const auto r = check(i, first, last, cancel[i]);
+			const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			lock.lock();
+			current[i] = SIZE_MAX;
+			busy--;
+			jobList[n].seconds = seconds;
+			jobList[n].cancelled = r == l_Undef && cancel[i].load() && !stopped;
+			record(n, r);
+			work.notify_all();
+		}
+	};
+	runWorkers(workers, runJobs, interrupt, [&] {
+		std::lock_guard<std::mutex> lock(m);
+		stopped = true;
+		for (auto i = 0; i != workers; i++) {
+			cancel[i].store(true);
+		}
+		work.notify_all();
+	});
+
+	if (satisfiable)
+		return l_True;
+	return safeDepth() == k ? l_False : l_Undef;
+}
+
+auto DepthScheduler::firstFailure() const -> int
+{
+	const auto d = safeDepth() + 1;
+	if (d < int(depths.size()) && (depths[d] == Fail || depths[d] == FailUnlessShorter))
+		return d;
+	return -1;
+}
+
+auto DepthScheduler::safeDepth() const -> int
+{
+	auto d = 0;
+	while (d < int(depths.size()) && depths[d] == Safe) {
+		d++;
+	}
+	return d - 1;
+}
+
+auto DepthScheduler::jobs() const -> const std::vector<Job> &
+{
+	return jobList;
+}
+
+auto parseDepthOrder(const std::string &name) -> DepthScheduler::Order
+{
+	if (name == "interleaved")
+		return DepthScheduler::Interleaved;
+	if (name == "geometric")
+		return DepthScheduler::Geometric;
+
+	throw std::invalid_argument("unknown depth order '" + name + "'");
+}
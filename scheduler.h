@@ -0,0 +1,64 @@
+#pragma once
+
+#include "MiniSat-p_v1.14/Solver.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// DepthScheduler checks the BMC depths 0..k as jobs on a pool of worker
+// threads. A job asks whether a bad state is reachable in exactly first..last
+// steps, so deeper jobs may finish before shallower ones; the smallest failing
+// depth is only reported once all depths below it are known to be safe.
+class DepthScheduler {
+public:
+	// Interleaved hands out the depths one by one in increasing order.
+	// Geometric hands out ranges of doubling length (0, 1, 2-3, 4-7, ...),
+	// which are split into single depths once they are found to fail.
+	enum Order { Interleaved, Geometric };
+
+	// Job records a range of depths and how it was checked.
+	struct Job {
+		int first, last;
+		lbool result = l_Undef;
+		int worker = -1; // -1 if the job was never started
+		bool cancelled = false; // stopped because a shallower failure was found
+		double seconds = 0;
+	};
+
+	// Check checks the depths first..last in the thread of worker. It returns
+	// l_Undef if it runs out of budget or cancel is set.
+	using Check = std::function<lbool(int worker, int first, int last, std::atomic<bool> &cancel)>;
+
+private:
+	enum Status { Unknown, Safe, Fail, FailUnlessShorter };
+
+	int workers;
+	Order order;
+	std::vector<Job> jobList;
+	std::vector<Status> depths;
+
+public:
+	DepthScheduler(int workers, Order order);
+
+	// run checks the depths 0..k. Setting interrupt stops all workers. It
+	// returns l_True if a counterexample was found, l_False if all depths are
+	// safe and l_Undef otherwise. Jobs above a failing depth are cancelled,
+	// the ones below it run to the end.
+	auto run(int k, const Check &check, const std::atomic<bool> &interrupt) -> lbool;
+
+	// firstFailure returns the smallest depth with a counterexample, or -1 if
+	// it is not known.
+	auto firstFailure() const -> int;
+
+	// safeDepth returns the depth up to which all depths are safe, or -1.
+	auto safeDepth() const -> int;
+
+	// jobs returns the jobs of the last run() in the order they were created.
+	auto jobs() const -> const std::vector<Job> &;
+};
+
+// parseDepthOrder converts "interleaved" or "geometric" to an Order. It throws
+// std::invalid_argument for other names.
+auto parseDepthOrder(const std::string &name) -> DepthScheduler::Order;
@@ -0,0 +1,153 @@
+#include "stats.h"
+
+#include <sstream>
+#include <sys/resource.h>
+
+// quote returns s as a JSON string.
+static auto quote(const std::string &s) -> std::string
+{
+	std::string q = "\"";
+	for (const auto c : s) {
+		if (c == '"' || c == '\\') {
+			q += '\\';
+			q += c;
+		} else if ((unsigned char)c < 0x20) {
+			const char hex[] = "0123456789abcdef";
+			q += "\\u00";
+			q += hex[c >> 4];
+			q += hex[c & 15];
+		} else {
+			q += c;
+		}
+	}
+	return q + "\"";
+}
+
+// number returns x as a JSON number.
+static auto number(double x) -> std::string
+{
+	std::ostringstream o;
+	o.precision(6);
+	o << x;
+	return o.str();
+}
+
+// seconds returns the time from `from` until now.
+static auto seconds(std::chrono::steady_clock::time_point from) -> double
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - from).count();
+}
+
+Stats::Stats() : start(std::chrono::steady_clock::now())
+{
+}
+
+void Stats::set(Values &vs, const std::string &key, std::string json)
+{
+	for (auto &v : vs) {
+		if (v.first == key) {
+			v.second = std::move(json);
+			return;
+		}
+	}
+	vs.emplace_back(key, std::move(json));
+}
+
+void Stats::set(const std::string &key, int64_t value)
+{
+	set(values, key, std::to_string(value));
+}
+
+void Stats::set(const std::string &key, const std::string &value)
+{
+	set(values, key, quote(value));
+}
+
+void Stats::writeJSON(std::ostream &o) const
+{
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	o << "{";
+	for (const auto &v : values) {
+		o << quote(v.first) << ": " << v.second << ", ";
+	}
+	o << "\"seconds\": " << number(seconds(start)) << ", ";
+	o << "\"peak_rss_kb\": " << usage.ru_maxrss << ", ";
+	o << "\"phases\": [";
+	for (size_t i = 0; i != phases.size(); i++) {
+		const auto &p = phases[i];
+		o << (i == 0 ? "" : ",") << "\n  {\"phase\": " << quote(p.name);
+		for (const auto &v : p.values) {
+			o << ", " << quote(v.first) << ": " << v.second;
+		}
+		o << ", \"seconds\": " << number(p.seconds) << "}";
+	}
+	o << "\n]}" << std::endl;
+}
+
+Stats::Phase::Phase(Stats *stats, const std::string &name, int depth, int iteration)
+    : stats(stats), index(0), start(std::chrono::steady_clock::now())
+{
+	if (stats == nullptr)
+		return;
+
+	index = stats->phases.size();
+	stats->phases.emplace_back();
+	stats->phases.back().name = name;
+	if (depth != -1)
+		set("depth", depth);
+	if (iteration != -1)
+		set("iteration", iteration);
+}
+
+Stats::Phase::~Phase()
+{
+	done();
+}
+
+void Stats::Phase::done()
+{
+	done(seconds(start));
+}
+
+void Stats::Phase::done(double seconds)
+{
+	if (stats != nullptr)
+		stats->phases[index].seconds = seconds;
+	stats = nullptr;
+}
+
+void Stats::Phase::set(const std::string &key, int64_t value)
+{
+	if (stats != nullptr)
+		Stats::set(stats->phases[index].values, key, std::to_string(value));
+}
+
+void Stats::Phase::set(const std::string &key, double value)
+{
+	if (stats != nullptr)
+		Stats::set(stats->phases[index].values, key, number(value));
+}
+
+void Stats::Phase::set(const std::string &key, const std::string &value)
+{
+	if (stats != nullptr)
+		Stats::set(stats->phases[index].values, key, quote(value));
+}
+
+void Stats::Phase::solver(Solver &s)
+{
+	set("vars", s.nVars());
+	set("clauses", s.nClauses());
+	set("learnts", s.nLearnts());
+	set("restarts", int64_t(s.stats.starts));
+	set("decisions", int64_t(s.stats.decisions));
+	set("propagations", int64_t(s.stats.propagations));
+	set("conflicts", int64_t(s.stats.conflicts));
+}
+
+auto satName(lbool sat) -> std::string
+{
+	return sat == l_True ? "sat" : sat == l_False ? "unsat" : "unknown";
+}
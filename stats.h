@@ -0,0 +1,77 @@
+#pragma once
+
+#include "MiniSat-p_v1.14/Solver.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Stats collects the phases of a model checking run (parsing, preprocessing,
+// BMC depths, interpolation iterations, ...) with their wall time and
+// counters, and writes them as JSON.
+class Stats {
+	// Values are kept as JSON text.
+	using Values = std::vector<std::pair<std::string, std::string>>;
+
+	struct Entry {
+		std::string name;
+		double seconds = 0;
+		Values values;
+	};
+
+	std::chrono::steady_clock::time_point start;
+	Values values;
+	std::vector<Entry> phases;
+
+	static void set(Values &vs, const std::string &key, std::string json);
+
+public:
+	Stats();
+
+	// Phase records one phase of a run in a Stats. Its wall time is measured
+	// from construction to destruction. A Phase on a null Stats does nothing,
+	// so the instrumentation can stay in place when no statistics are wanted.
+	class Phase {
+		Stats *stats;
+		size_t index;
+		std::chrono::steady_clock::time_point start;
+
+	public:
+		// depth and iteration are recorded unless they are -1.
+		Phase(Stats *stats, const std::string &name, int depth = -1, int iteration = -1);
+		~Phase();
+
+		// done ends the phase before the destructor would.
+		void done();
+
+		// done(seconds) ends the phase with the given wall time instead of the
+		// measured one, for work that was timed elsewhere (e.g. in a thread).
+		void done(double seconds);
+
+		Phase(const Phase &) = delete;
+		auto operator=(const Phase &) -> Phase & = delete;
+
+		void set(const std::string &key, int value) { set(key, int64_t(value)); }
+		void set(const std::string &key, int64_t value);
+		void set(const std::string &key, double value);
+		void set(const std::string &key, const std::string &value);
+
+		// solver records the size and the search statistics of s.
+		void solver(Solver &s);
+	};
+
+	// set records a value of the whole run.
+	void set(const std::string &key, int value) { set(key, int64_t(value)); }
+	void set(const std::string &key, int64_t value);
+	void set(const std::string &key, const std::string &value);
+
+	// writeJSON writes the values of the run, its total wall time, the peak
+	// resident set size and all phases.
+	void writeJSON(std::ostream &o) const;
+};
+
+// satName names the result of a SAT call for the statistics.
+auto satName(lbool sat) -> std::string;
@@ -0,0 +1,29 @@
+#!/bin/sh
+
+# the interpolants of the proof recorded during the search have to give
+# the same results as those of the proof replayed after it (--offline-proof),
+# also when the solver deleted learnt clauses that the refutation depends on.
+models='cmu.dme1.B cmu.dme2.B cmu.gigamax.B'
+
+echo "proofs tests"
+count=0
+failed=0
+for engine in '-i' '--itp-seq'
+do
+	for m in $models
+	do
+		printf "trying %-15s %-10s " "$m" "$engine"
+		online=`./boumc -k 15 $engine -f examples/advanced/$m.aag 2>&1 | tail -n 1`
+		offline=`./boumc -k 15 $engine --offline-proof -f examples/advanced/$m.aag 2>&1 | tail -n 1`
+		if [ "$online" = "$offline" ] && { [ "$online" = OK ] || [ "$online" = FAIL ]; }; then
+			echo "[OK]"
+		else
+			echo "[FAIL]"
+			failed=$((failed+1))
+		fi
+		count=$((count+1))
+	done
+done
+echo
+
+printf "$failed/$count of proofs tests failed\n\n"
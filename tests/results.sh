@@ -0,0 +1,74 @@
+#!/bin/sh
+
+# check runs boumc on a model of examples/basic and compares the result.
+# usage: check <model> <result> <output line or ''> <boumc options...>
+count=0
+failed=0
+check()
+{
+	model=$1; result=$2; line=$3; shift 3
+	printf "trying %-20s %-32s " "$model" "$*"
+	out=`./boumc "$@" -f examples/basic/$model.aag 2>/dev/null`
+	if [ "`echo "$out" | tail -n 1`" = "$result" ] && { [ -z "$line" ] || echo "$out" | grep -q "$line"; }; then
+		echo "[OK]"
+	else
+		echo "[FAIL]"
+		failed=$((failed+1))
+	fi
+	count=$((count+1))
+}
+
+echo "results tests"
+
+# the constraints only have to hold up to the bad state, at every k.
+for k in 0 1 5
+do
+	for engine in '' '-j 2' '--cubes 2' '--latch-alias' '--transfer-learnts' '--enlarge 1'
+	do
+		check constraintdepth FAIL '' -k $k $engine
+		check constraintcube OK '' -k $k $engine
+		check constraints OK '' -k $k $engine
+	done
+	for engine in '--exact-depth' '--abstract' '--direction backward' '--direction both' '--schedule geometric -j 2'
+	do
+		check constraintdepth FAIL 'shortest counterexample at depth 0' -k $k $engine
+		check constraintcube OK '' -k $k $engine
+		check constraints OK '' -k $k $engine
+	done
+done
+for engine in '-i' '--itp-seq'
+do
+	check constraintdepth FAIL '' -k 5 $engine
+	check constraintcube OK '' -k 5 $engine
+	check constraints OK '' -k 5 $engine
+done
+
+# every property is reported with the depth it fails at or holds up to.
+for engine in '' '--exact-depth' '--latch-alias'
+do
+	check properties FAIL 'b3  *2  *FAIL  *1$' -k 1 $engine
+	check properties FAIL 'o0  *12  *OK  *up to 1$' -k 1 $engine
+	check properties FAIL 'o0  *12  *FAIL  *3$' -k 5 $engine
+	check properties FAIL 'b0  *14  *OK  *proven at 0$' -k 5 $engine
+	check properties FAIL 'b1  *16  *OK  *proven at 1$' -k 5 $engine
+	check properties FAIL 'b2  *18  *OK  *up to 5$' -k 5 $engine
+done
+
+# the target is only enlarged by preimages of fewer than 32 cubes.
+check parity5 OK 'target enlarged by 1 steps with 16 cubes' -k 3 --enlarge 1
+check parity6 OK 'target enlarged by 0 steps with 0 cubes' -k 3 --enlarge 1
+
+# enough depths that the scheduler grows its jobs while it records one.
+for order in geometric interleaved
+do
+	check latchline FAIL 'shortest counterexample at depth 3' -k 64 -j 2 --schedule $order
+done
+
+# options that an engine would ignore are rejected.
+check latch 'error: --interpolate cannot be combined with --abstract' '' -k 3 -i --abstract
+check latch 'error: --latch-alias cannot be combined with --abstract' '' -k 3 --abstract --latch-alias
+check latch 'error: -j cannot be combined with --exact-depth' '' -k 3 -j 2 --exact-depth
+check latch 'error: --itp-seq only supports --itp-system mcmillan' '' -k 3 --itp-seq --itp-system pudlak
+check properties 'error: a model with several properties is only checked by BMC depth by depth, which supports --exact-depth and --latch-alias' '' -k 3 -j 2
+
+printf "\n$failed/$count of results tests failed\n\n"
@@ -0,0 +1,131 @@
+#include "translate.h"
+#include "MiniSat-p_v1.14/SimpSolver.h"
+
+#include <algorithm>
+#include <set>
+
+// transferSize is the size up to which learnt clauses are carried over to the
+// next depth by transferMC.
+static const int transferSize = 8;
+
+auto AIGtoSATer::transferMC(int k) const -> Result
+{
+	if (aig.outputs.size() != 1) {
+		throw ErrOutputNotSingular;
+	}
+
+	// Carried is a clause for the next depth. A clause derived from the
+	// initial state is only imported under its activation literal.
+	struct Carried {
+		std::vector<Lit> lits;
+		bool initial;
+		int lbd;
+	};
+	std::vector<Carried> carried;
+
+	return depthByDepth(k, [&](int d, DepthCheck &depth) {
+		SimpSolver s;
+		s.default_params = searchParams;
+		SolverCNFer scnfer{s};
+		VarTranslator vars{&scnfer, aig.lastLit/2, d};
+
+		// the learnt clauses that depend on the initial state or on the bad
+		// states contain the negation of these activation literals.
+		const auto init = Lit(s.newVar()), bad = Lit(s.newVar());
+		I(scnfer, vars, init);
+		for (auto i = 0; i != d; i++) {
+			T(scnfer, vars, i);
+			C(scnfer, vars, i + 1);
+		}
+		vec<Lit> clause;
+		for (auto i = 0; i <= d; i++) {
+			clause.push(vars.toLit(aig.outputs[0], i));
+		}
+		clause.push(~bad);
+		s.addClause(clause);
+
+		vec<vec<Lit>> imports;
+		vec<int> lbds;
+		for (const auto &c : carried) {
+			imports.push();
+			for (const auto lit : c.lits) {
+				imports.last().push(lit);
+			}
+			if (c.initial)
+				imports.last().push(~init);
+			lbds.push(c.lbd);
+		}
+		s.addLearnts(imports, lbds);
+
+		if (variableElimination) {
+			for (const auto lit : {vars.True(), init, bad}) {
+				s.setFrozen(var(lit), true);
+			}
+			s.eliminate();
+		} else {
+			s.use_elim = false;
+		}
+
+		// the depths below d are refuted, so a bad state found now is one of
+		// a shortest counterexample.
+		const auto sat = solveDepth(s, {vars.True(), init, bad}, depth);
+		if (sat != l_False) {
+			return sat;
+		}
+
+		// clauses derived from the transition steps alone stay implied when
+		// they are shifted by one frame, as the next depth has all the steps
+		// they were derived from one frame later, too.
+		const auto imported = s.stats.imported;
+		const auto used = s.stats.imported_used;
+		vec<vec<Lit>> learnts;
+		lbds.clear();
+		s.learntClauses(transferSize, learnts, lbds);
+
+		std::set<std::pair<std::vector<Lit>, bool>> seen;
+		auto shifted = 0, dropped = 0;
+		carried.clear();
+		const auto add = [&](std::vector<Lit> lits, bool initial, int lbd) {
+			std::sort(lits.begin(), lits.end());
+			if (seen.insert({lits, initial}).second)
+				carried.push_back(Carried{std::move(lits), initial, lbd});
+		};
+		for (auto i = 0; i != learnts.size(); i++) {
+			std::vector<Lit> lits;
+			auto initial = false, final = false;
+			for (const auto lit : learnts[i]) {
+				if (var(lit) == var(init))
+					initial = true;
+				else if (var(lit) == var(bad))
+					final = true;
+				else
+					lits.push_back(lit);
+			}
+			if (final) {
+				dropped++;
+				continue;
+			}
+			if (!initial) {
+				std::vector<Lit> next;
+				for (const auto lit : lits) {
+					next.push_back(vars.timeShift(lit, 1));
+				}
+				add(std::move(next), false, lbds[i]);
+				shifted++;
+			}
+			add(std::move(lits), initial, lbds[i]);
+		}
+
+		depth.report << ", " << imported << " clauses imported, " << used << " used in conflicts";
+		if (imported > 0)
+			depth.report << " (" << 100 * used / imported << "%)";
+		depth.report << ", " << carried.size() << " carried over (" << shifted << " shifted, "
+		             << dropped << " dropped for depending on the bad states)";
+		depth.phase.set("imported", int64_t(imported));
+		depth.phase.set("imported_used", int64_t(used));
+		depth.phase.set("carried", int(carried.size()));
+		depth.phase.set("shifted", shifted);
+		depth.phase.set("dropped", dropped);
+		return sat;
+	});
+}
@@ -1,4 +1,9 @@
 #include "translate.h"
+#include "circuit.h"
+#include "interpolant.h"
+#include "cubes.h"
+#include "portfolio.h"
+#include "MiniSat-p_v1.14/SimpSolver.h"
 
 #include <algorithm>
 
@@ -62,6 +67,11 @@ auto VarTranslator::toLit(int var, int step) const -> Lit
 	if (v == 0)
 		return sgn ? True() : False();
 
+	if (step > 0 && v < (int)next.size() && next[v] != -1) {
+		const auto lit = toLit(next[v], step - 1);
+		return sgn ? ~lit : lit;
+	}
+
 	const auto n = first + (v-1) + step*numVars; 
 
 	//std::cout << "numVars = " << numVars << std::endl;
@@ -86,9 +96,30 @@ auto VarTranslator::toLit(int var, int step) const -> Lit
 	return Lit(n, sgn);
 };
 
+void VarTranslator::aliasLatches(const std::vector<std::pair<int, int>> &latches)
+{
+	for (const auto &latch : latches) {
+		const auto v = latch.first / 2;
+		if (v >= (int)next.size())
+			next.resize(v + 1, -1);
+		next[v] = latch.second;
+	}
+}
+
+auto VarTranslator::latchesAliased() const -> bool
+{
+	return !next.empty();
+}
+
+auto VarTranslator::varsPerStep() const -> int
+{
+	return numVars;
+}
+
 auto VarTranslator::timeIndex(Lit lit) const -> int
 {
-	if(var(lit) == 0 || numVars == 0) {
+	assert(!latchesAliased());
+	if(var(lit) < first || numVars == 0) {
 		return 0;
 	}
 
@@ -97,156 +128,243 @@ auto VarTranslator::timeIndex(Lit lit) const -> int
 
 auto VarTranslator::timeShift(Lit lit, int shift) const -> Lit
 {
-	if(var(lit) == 0)
-		throw "cannot shift true/false constants";
-	
+	assert(!latchesAliased());
+	if(var(lit) < first)
+		return lit;
+
 	return Lit(var(lit) + shift*numVars, sign(lit));
 }
 
 TranslationError ErrNegatedOutput{"AIGtoSATer: outputs are expected to be non-negated"};
 TranslationError ErrOutputNotSingular{"AIGtoSATer: only exactly one output is supported"};
 
-const char VertexRoot[] = "root";
-const char VertexChain[] = "chain";
+static std::unique_ptr<Solver> newSolver(ProofTraverser *trav, const SearchParams &params)
+{
+	auto s = std::make_unique<Solver>();
+	s->proof = nullptr;
+	s->default_params = params;
+	
+	// proof needs to be assigned before newVar() is called on the Solver...
+	if(trav != nullptr)
+		s->proof = new Proof{*trav};
 
-struct Vertex {
-	const char *type = nullptr; // VertexRoot or VertexChain
+	return s;
+}
 
-	vec<Lit> c;
-	vec<ClauseId> cs;
-	vec<Var> xs;
-	bool partOfA;
+// proofRecorder returns a proof traverser that records the refutation DAG in
+// `proof`. Roots are assigned to the partition that `part` is set to when they
+// are added to the solver. A clause the solver deletes may still be an
+// antecedent of live clauses, so its vertex is only freed once no other
+// vertex uses it.
+static auto proofRecorder(std::vector<Vertex> &proof, const int &part)
+{
+	return makeTraverser([&](const auto& c){ // root
+		Vertex vx(VertexRoot);
+		vx.c = c;
+		vx.part = part;
 
-	Lit lit; // lit is a literal equivalent to pc (i.e. (lit <-> pc) is part of the interpolant) if referenced == true
-	
-	bool referenced = false; // lit is populated
-	bool deleted = false; // deleted was called on the vertex.
+		proof.push_back(std::move(vx));
+	}, [&](const auto& cs, const auto& xs){ // chain
+		Vertex vx(VertexChain);
 
-	Vertex() {}
-	
-	Vertex(const char *type) : type(type) {}
+		assert(cs.size() == xs.size()+1);
 
-	auto assignLit(const VecCNFer& A, const VecCNFer& B, const VarTranslator& vars, Vertex *begin, CNFer& itp) -> Lit {
-		if (deleted) {
-			std::cout << "warning: chain on deleted clause" << std::endl;
-			//throw std::runtime_error("chain on deleted clause");
-			return vars.False();
+		vx.cs = cs;
+		vx.xs = xs;
+		for (auto i = 0; i < cs.size(); i++) {
+			proof[cs[i]].uses++;
 		}
 
-		if (referenced) {
-			return lit;
+		proof.push_back(std::move(vx));
+	}, [&]{ /* done */ }, [&](ClauseId c){ // deleted
+		proof[c].deleted = true;
+		std::vector<ClauseId> unused{c};
+		while (!unused.empty()) {
+			auto &vx = proof[unused.back()];
+			unused.pop_back();
+			if (!vx.deleted || vx.uses != 0 || vx.freed)
+				continue;
+
+			for (auto i = 0; i < vx.cs.size(); i++) {
+				proof[vx.cs[i]].uses--;
+				unused.push_back(vx.cs[i]);
+			}
+			vx.c.clear(true);
+			vx.cs.clear(true);
+			vx.xs.clear(true);
+			vx.freed = true;
 		}
+	});
+}
 
-		//std::cout << "assignLit " << type << std::endl;
+// OfflineRefutation is the core of an offline proof: the clauses the last
+// derived clause (the refutation) depends on. Interpolants are computed by
+// replaying the core from disk, so neither the proof nor the refutation DAG
+// has to fit in memory.
+class OfflineRefutation {
+	Proof core;
+	vec<ClauseId> ids; // ids[c] is the ID of clause c of core in the proof
+	std::vector<ClauseId> partEnd;
+
+public:
+	// partEnd holds the ID of the last clause added for every partition.
+	OfflineRefutation(Proof &proof, std::vector<ClauseId> partEnd)
+	    : partEnd(std::move(partEnd))
+	{
+		const auto goal = proof.last();
+		proof.compress(core, goal, &ids);
+		std::cout << "proof core " << ids.size() << " of " << goal + 1 << " clauses" << std::endl;
+	}
 
-		if (type == VertexRoot) {
-			if (partOfA) {
-				lit = Lit(itp.newVar(), false);
-				
-				vec<Lit> pc; // p(c) is only a disjunction in this case
+	auto interpolant(ItpContext &ctx) -> Lit
+	{
+		ItpTraverser trav(ctx, [&](ClauseId c) {
+			const auto it = std::lower_bound(partEnd.cbegin(), partEnd.cend(), ids[c]);
+			return int(it - partEnd.cbegin());
+		});
+		core.traverse(trav);
+		return trav.result();
+	}
+};
 
-				// compute globals by only adding the variables to p(c) that are in B.
-				// We know they are in A because of the if condition above.
-				std::for_each(c.begin(), c.end(), [&](const auto lit) {
-					if(B.contains(lit)) {
-						pc.push(lit);
-					}
-				});
+// RefutationSolver is a Solver whose refutation can be interpolated. The
+// proof is recorded as a DAG while solving or, with offline proofs, written
+// to a temporary file and replayed afterwards; then partitions are told apart
+// by clause IDs. Clauses belong to the partition that is open when they are
+// added to the solver, the first one is 0.
+class RefutationSolver {
+	std::vector<Vertex> proof;
+	int part = 0;
+	std::unique_ptr<ProofTraverser> recorder;
+	std::unique_ptr<Proof> offline;
+	std::vector<ClauseId> partEnd;
+	std::unique_ptr<OfflineRefutation> refutation;
+
+public:
+	std::unique_ptr<Solver> s;
+
+	RefutationSolver(bool offlineProofs, const SearchParams &params)
+	{
+		if (offlineProofs) {
+			offline = std::make_unique<Proof>();
+			s = newSolver(nullptr, params);
+			s->proof = offline.get();
+		} else {
+			auto rec = proofRecorder(proof, part);
+			recorder = std::make_unique<decltype(rec)>(std::move(rec));
+			s = newSolver(recorder.get(), params);
+		}
+	}
 
-				if (pc.size() != 0) {
-					// add to itp: lit <-> p(c)
-		
-					for(auto x : pc) {
-						itp.addBinary(~x, lit);
-					}
-
-					pc.push(~lit);
-					itp.addClause(pc);
-				}else{
-					lit = vars.False();
-				}
-			} else {
-				lit = vars.True();
-			}
+	// the recorder refers to proof and part.
+	RefutationSolver(const RefutationSolver &) = delete;
+	RefutationSolver &operator=(const RefutationSolver &) = delete;
 
-			referenced = true;
-		}else if(type == VertexChain) {
-			const auto xssz = xs.size();
-
-			lit = begin[cs[0]].assignLit(A, B, vars, begin, itp);
-
-			for(auto i = 0; i < xssz; i++) {
-				const auto c2 = cs[i+1];
-				const auto v = xs[i]; // pivot variable
-
-				//std::cout << "pivot " << v << std::endl;
-
-				const auto pc1 = lit;
-				const auto pc2 = begin[c2].assignLit(A, B, vars, begin, itp);
-
-				if(B.contains(Lit(v, false))) {
-					// i.e. lit <-> (p(c1) ^ p(c2))
-					if(pc1 == vars.True()) {
-						lit = pc2;
-						continue;
-					}else if(pc2 == vars.True()) {
-						lit = pc1;
-						continue;
-					}else if(pc1 == vars.False() || pc2 == vars.False()) {
-						lit = vars.False();
-						continue;
-					}
-
-					lit = Lit(itp.newVar(), false);
-					itp.addBinary(pc1, ~lit);
-					itp.addBinary(pc2, ~lit);
-					itp.addTernary(lit, ~pc1, ~pc2);
-				}else{
-					// i.e. lit <-> (p(c1) v p(c2))
-					if(pc1 == vars.False()) {
-						lit = pc2;
-						continue;
-					}else if(pc2 == vars.False()) {
-						lit = pc1;
-						continue;
-					}else if(pc1 == vars.True() || pc2 == vars.True()) {
-						lit = vars.True();
-						continue;
-					}
-
-					lit = Lit(itp.newVar(), false);
-					itp.addBinary(~pc1, lit);
-					itp.addBinary(~pc2, lit);
-					itp.addTernary(~lit, pc1, pc2);
-				}
-			}
+	// endPartition closes the open partition and opens the next one.
+	void endPartition()
+	{
+		partEnd.push_back(s->proof->last());
+		part++;
+	}
 
-			referenced = true;
-		}else{
-			throw std::domain_error("type of vertex: neither root nor chain");
+	// interpolant returns the interpolant of the refutation between the
+	// partitions up to `cut` and the rest. The solver must have been UNSAT.
+	auto interpolant(const ItpPartitions &parts, int cut, ItpSystem system, Circuit &circuit) -> Lit
+	{
+		ItpContext ctx{parts, cut, system, proof.data(), circuit};
+		if (offline) {
+			if (!refutation)
+				refutation = std::make_unique<OfflineRefutation>(*offline, partEnd);
+			return refutation->interpolant(ctx);
 		}
-		
-		assert(referenced);
-		
-		return lit;
+
+		for (auto &vx : proof) {
+			vx.referenced = false;
+		}
+		return proof.back().assignLit(ctx);
 	}
 };
 
+// FixpointStats counts how often each layer of the R' -> R check decided.
+struct FixpointStats {
+	int constant = 0;
+	int structural = 0;
+	int simulation = 0;
+	int sat = 0;
+};
 
-static std::unique_ptr<Solver> newSolver(ProofTraverser *trav)
+static auto operator<<(std::ostream &o, const FixpointStats &st) -> std::ostream &
 {
-	auto s = std::make_unique<Solver>();
-	s->proof = nullptr;
-	
-	// proof needs to be assigned before newVar() is called on the Solver...
-	if(trav != nullptr)
-		s->proof = new Proof{*trav};
+	return o << "fixpoint checks decided by constants " << st.constant << ", structure "
+	         << st.structural << ", simulation " << st.simulation << ", SAT " << st.sat;
+}
 
-	return s;
+// cheapFixpointCheck tries to decide R2 -> R without a Solver: by constants,
+// by structure (all disjuncts of R2 are disjuncts of R) and by simulation
+// with random states. It returns l_True or l_False if one of these layers
+// decided and l_Undef otherwise.
+static auto cheapFixpointCheck(const Circuit &c, Lit R2, Lit R, FixpointStats &st) -> lbool
+{
+	if (R2 == c.False() || R == c.True()) {
+		st.constant++;
+		return l_True;
+	}
+	if (R2 == c.True() && R == c.False()) {
+		st.constant++;
+		return l_False;
+	}
+
+	if (R2 == R) {
+		st.structural++;
+		return l_True;
+	}
+	const auto ds = c.disjuncts(R);
+	const auto inR = [&](Lit d) { return std::find(ds.cbegin(), ds.cend(), d) != ds.cend(); };
+	const auto ds2 = c.disjuncts(R2);
+	if (std::all_of(ds2.cbegin(), ds2.cend(), inR)) {
+		st.structural++;
+		return l_True;
+	}
+
+	if (!c.mayImply(R2, R)) {
+		st.simulation++;
+		return l_False;
+	}
+
+	return l_Undef;
+}
+
+auto parseBmcDirection(const std::string &name) -> BmcDirection
+{
+	if (name == "forward")
+		return BmcDirection::Forward;
+	if (name == "backward")
+		return BmcDirection::Backward;
+	if (name == "both")
+		return BmcDirection::Bidirectional;
+
+	throw std::invalid_argument("unknown BMC direction '" + name + "'");
+}
+
+auto parseRestartPolicy(const std::string &name) -> RestartPolicy
+{
+	if (name == "geometric")
+		return restart_Geometric;
+	if (name == "luby")
+		return restart_Luby;
+	if (name == "glucose")
+		return restart_Glucose;
+
+	throw std::invalid_argument("unknown restart policy '" + name + "'");
 }
 
 AIGtoSATer::AIGtoSATer(const AIG &aig) : aig(aig)
 {
+	// the model checkers restart like Glucose and save phases, the other
+	// solvers (e.g. of the circuit simplification) keep MiniSat's defaults.
+	searchParams = Solver().default_params;
+	searchParams.restarts = restart_Glucose;
+	searchParams.phase_saving = true;
 }
 
 void AIGtoSATer::andgates(CNFer& s, VarTranslator& vars, int step) const
@@ -266,23 +384,122 @@ void AIGtoSATer::andgates(CNFer& s, VarTranslator& vars, int step) const
 	}
 }
 
-void AIGtoSATer::I(CNFer& s, VarTranslator& vars) const
+void AIGtoSATer::C(CNFer& s, VarTranslator& vars, int step) const
 {
-	// Initial latch output is zero.
-	for (const auto &latch : aig.latches) {
-		if (latch.first % 2 != 0) {
-			throw ErrNegatedOutput;
-		}
+	for (const auto c : aig.constraints) {
+		s.addUnit(vars.toLit(c, step));
+	}
+}
+
+auto AIGtoSATer::constrained(CNFer& s, VarTranslator& vars, Lit ok, int step) const -> Lit
+{
+	if (aig.constraints.empty()) {
+		return ok;
+	}
 
-		// std::cout << "var " << latch.first << "_0 <- 0 (Latch output, input = "
-		// << latch.second << ")" << std::endl;
-		s.addUnit(~vars.toLit(latch.first, 0));
+	// only ok_step -> ok and ok_step -> c are needed, since ok_step is only
+	// ever required, never refuted.
+	const auto x = Lit(s.newVar());
+	if (ok != vars.True())
+		s.addBinary(~x, ok);
+	for (const auto c : aig.constraints) {
+		s.addBinary(~x, vars.toLit(c, step));
+	}
+	return x;
+}
+
+auto AIGtoSATer::resetLit(VarTranslator& vars, size_t l, int step) const -> Lit
+{
+	const auto &latch = aig.latches[l];
+	if (latch.first % 2 != 0) {
+		throw ErrNegatedOutput;
+	}
+
+	const auto reset = aig.resets[l];
+	if (reset == latch.first)
+		return lit_Undef;
+	const auto q = vars.toLit(latch.first, step);
+	return reset == 1 ? q : ~q;
+}
+
+void AIGtoSATer::I(CNFer& s, VarTranslator& vars, Lit act) const
+{
+	// Initial latch outputs are their reset values.
+	for (size_t l = 0; l != aig.latches.size(); l++) {
+		const auto x = resetLit(vars, l, 0);
+		if (x == lit_Undef)
+			continue;
+
+		if (act == lit_Undef)
+			s.addUnit(x);
+		else
+			s.addBinary(x, ~act);
 	}
 
 	andgates(s, vars, 0);
+	C(s, vars, 0);
+}
+
+FrameTemplate::FrameTemplate(const VecCNFer &step0, const VarTranslator &vars) : varsPerStep(vars.varsPerStep())
+{
+	for (const auto &clause : step0.raw()) {
+		for (const auto lit : clause) {
+			lits.push_back(index(lit));
+			moves.push_back(var(lit) != var(vars.False()));
+		}
+		sizes.push(clause.size());
+	}
+}
+
+auto FrameTemplate::fits(const VarTranslator &vars) const -> bool
+{
+	return !vars.latchesAliased() && vars.varsPerStep() == varsPerStep;
+}
+
+void FrameTemplate::instantiate(CNFer &s, int step) const
+{
+	// a literal is moved by one frame by adding twice the variables per step.
+	const auto offset = 2 * step * varsPerStep;
+	vec<Lit> frame(lits.size());
+	for (size_t i = 0; i != lits.size(); i++) {
+		frame[i] = toLit(lits[i] + moves[i] * offset);
+	}
+	s.addClauses(frame, sizes);
 }
 
 void AIGtoSATer::T(CNFer& s, VarTranslator& vars, int step) const
+{
+	// with aliased latches, a step may refer back to the latches of step 0,
+	// so the steps differ by more than an offset.
+	if (vars.latchesAliased()) {
+		encodeT(s, vars, step);
+		return;
+	}
+
+	std::shared_ptr<const FrameTemplate> tmpl;
+	{
+		std::lock_guard<std::mutex> lock(frameTemplateLock);
+		if (!frameTemplate || !frameTemplate->fits(vars)) {
+			VecCNFer step0;
+			encodeT(step0, vars, 0);
+			frameTemplate = std::make_shared<const FrameTemplate>(step0, vars);
+		}
+		tmpl = frameTemplate;
+	}
+	tmpl->instantiate(s, step);
+}
+
+void AIGtoSATer::encodeT(CNFer& s, VarTranslator& vars, int step) const
+{
+	// Aliased latches need no clauses.
+	if (!vars.latchesAliased()) {
+		latchSteps(s, vars, step);
+	}
+
+	andgates(s, vars, step + 1);
+}
+
+void AIGtoSATer::latchSteps(CNFer& s, VarTranslator& vars, int step) const
 {
 	// Latch transition function: q(n+1) <-> d(n).
 	for (const auto &latch : aig.latches) {
@@ -291,18 +508,31 @@ void AIGtoSATer::T(CNFer& s, VarTranslator& vars, int step) const
 		s.addBinary(~vars.toLit(latch.first, step + 1), vars.toLit(latch.second, step));
 		s.addBinary(vars.toLit(latch.first, step + 1), ~vars.toLit(latch.second, step));
 	}
-
-	andgates(s, vars, step + 1);
 }
 
-void AIGtoSATer::F(CNFer& s, VarTranslator& vars, int from, int to) const
+void AIGtoSATer::F(CNFer& s, VarTranslator& vars, int from, int to, Lit act) const
 {
-	vec<Lit> clause(to-from+1);
-
-	for(int i = from, j = 0; i <= to; i++) {
-		clause[j++] = vars.toLit(aig.outputs[0], i);
+	vec<Lit> clause;
+
+	// a bad state at step i only counts if the constraints hold up to i.
+	auto ok = vars.True();
+	for(int i = from; i <= to; i++) {
+		if (i > from)
+			ok = constrained(s, vars, ok, i);
+
+		const auto bad = vars.toLit(aig.outputs[0], i);
+		if (ok == vars.True()) {
+			clause.push(bad);
+			continue;
+		}
+		const auto x = Lit(s.newVar());
+		s.addBinary(~x, bad);
+		s.addBinary(~x, ok);
+		clause.push(x);
 	}
 
+	if (act != lit_Undef)
+		clause.push(~act);
 	s.addClause(clause);
 }
 
@@ -325,6 +555,171 @@ void AIGtoSATer::enableInterpolation() {
 	interpolation = true;
 }
 
+void AIGtoSATer::enableInterpolationSequence() {
+	interpolationSequence = true;
+}
+
+void AIGtoSATer::setInterpolantMinimization(bool yes) {
+	minimizeInterpolants = yes;
+}
+
+void AIGtoSATer::setInterpolationSystem(ItpSystem system) {
+	itpSystem = system;
+}
+
+void AIGtoSATer::enableOfflineProofs() {
+	offlineProofs = true;
+}
+
+void AIGtoSATer::setRestartPolicy(RestartPolicy policy) {
+	searchParams.restarts = policy;
+}
+
+void AIGtoSATer::setPhaseSaving(bool yes) {
+	searchParams.phase_saving = yes;
+}
+
+void AIGtoSATer::setVariableElimination(bool yes) {
+	variableElimination = yes;
+}
+
+void AIGtoSATer::setLatchAliasing(bool yes) {
+	latchAliasing = yes;
+}
+
+void AIGtoSATer::setParallelWorkers(int n) {
+	parallelWorkers = n;
+}
+
+void AIGtoSATer::setCubeDepth(int depth) {
+	cubeDepth = depth;
+}
+
+void AIGtoSATer::setDepthScheduling(DepthScheduler::Order order) {
+	depthScheduling = true;
+	depthOrder = order;
+}
+
+void AIGtoSATer::setExactDepth(bool yes) {
+	exactDepth = yes;
+}
+
+void AIGtoSATer::setDepthOffset(int steps) {
+	depthOffset = steps;
+}
+
+void AIGtoSATer::setAbstraction(bool yes) {
+	abstraction = yes;
+}
+
+void AIGtoSATer::setDirection(BmcDirection direction) {
+	this->direction = direction;
+}
+
+void AIGtoSATer::setLearntTransfer(bool yes) {
+	learntTransfer = yes;
+}
+
+void AIGtoSATer::setConflictLimit(int64_t conflicts) {
+	conflictLimit = conflicts;
+}
+
+void AIGtoSATer::setDepthTimeLimit(double seconds) {
+	depthTimeLimit = seconds;
+}
+
+void AIGtoSATer::setStats(Stats *stats) {
+	this->stats = stats;
+}
+
+void AIGtoSATer::interrupt() {
+	interrupted.store(true);
+}
+
+auto AIGtoSATer::undecided(int k, int safe) const -> Result
+{
+	std::cout << "limit reached at depth " << k + depthOffset;
+	if (safe >= 0)
+		std::cout << ", no counterexample up to depth " << safe + depthOffset;
+	std::cout << std::endl;
+
+	return UNDECIDED;
+}
+
+void AIGtoSATer::reportShortest(int depth) const
+{
+	// an enlarged target at step 0 may be a bad state at any step up to the
+	// offset.
+	if (depth == 0 && depthOffset > 0)
+		std::cout << "shortest counterexample at depth " << depthOffset << " or less" << std::endl;
+	else
+		std::cout << "shortest counterexample at depth " << depth + depthOffset << std::endl;
+}
+
+auto AIGtoSATer::depthDeadlineFromNow() const -> std::chrono::steady_clock::time_point
+{
+	return std::chrono::steady_clock::now() +
+	       std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+	           std::chrono::duration<double>(depthTimeLimit));
+}
+
+void AIGtoSATer::startDepth() const
+{
+	if (depthTimeLimit >= 0) {
+		depthDeadline = depthDeadlineFromNow();
+	}
+}
+
+void AIGtoSATer::applyBudget(Solver &s) const
+{
+	applyBudget(s, depthDeadline);
+}
+
+void AIGtoSATer::applyBudget(Solver &s, std::chrono::steady_clock::time_point deadline) const
+{
+	s.budgetOff();
+	s.interrupt_flag = &interrupted;
+
+	if (conflictLimit >= 0)
+		s.setConfBudget(conflictLimit);
+
+	if (depthTimeLimit >= 0) {
+		const std::chrono::duration<double> left = deadline - std::chrono::steady_clock::now();
+		s.setTimeBudget(std::max(left.count(), 0.0));
+	}
+}
+
+auto AIGtoSATer::depthByDepth(int k, const std::function<lbool(int d, DepthCheck &depth)> &check) const -> Result
+{
+	for (auto d = 0; d <= k; d++) {
+		startDepth();
+		DepthCheck depth(stats, d);
+		const auto sat = check(d, depth);
+		std::cout << "depth " << d << ": " << (sat == l_True ? "SAT" : sat == l_False ? "UNSAT" : "undecided")
+		          << ", " << depth.conflicts << " conflicts" << depth.report.str() << std::endl;
+		depth.phase.set("result", satName(sat));
+		if (sat == l_True) {
+			reportShortest(d);
+			return FAIL;
+		}
+		if (sat == l_Undef) {
+			return undecided(d, d - 1);
+		}
+	}
+
+	return OK;
+}
+
+auto AIGtoSATer::solveDepth(Solver &s, const vec<Lit> &assumps, DepthCheck &depth) const -> lbool
+{
+	applyBudget(s);
+	const auto conflicts = s.stats.conflicts;
+	const auto sat = s.solveLimited(assumps);
+	depth.conflicts += s.stats.conflicts - conflicts;
+	depth.phase.solver(s);
+	return sat;
+}
+
 auto AIGtoSATer::mcmillanMC(int k) const -> Result
 {
 	const auto K = k;
@@ -332,24 +727,42 @@ auto AIGtoSATer::mcmillanMC(int k) const -> Result
 
 	VarTranslator vars;
 	{
-		auto s = newSolver(nullptr);
+		startDepth();
+		Stats::Phase depth(stats, "bmc", 0);
+		auto s = newSolver(nullptr, searchParams);
 		SolverCNFer scnfer{*s};
 		vars.reset(&scnfer, numVars, 0);
 
 		I(scnfer, vars);
 		F(scnfer, vars, 0, 0);
 
-		if(s->solve({vars.True()})) {
+		applyBudget(*s);
+		const auto sat = s->solveLimited({vars.True()});
+		depth.solver(*s);
+		depth.set("result", satName(sat));
+		if(sat == l_Undef) {
+			return undecided(0, -1);
+		}
+		if(sat == l_True) {
 			return FAIL;
 		}
 	}
 
+	// all paths up to this length are free of bad states.
+	auto safe = 0;
+
 	VecCNFer firstR;
 	I(firstR, vars);
-	if(firstR.raw().size() == 0)
-		firstR.addUnit(vars.True());
+
+	// R is kept as a circuit over the variables of time index 0, so that
+	// interpolants can be simplified before they are added to it.
+	Circuit circuit(vars.False());
+	const auto initR = circuit.fromCNF(firstR.raw());
+	FixpointStats fixpointStats;
 
 	for(k = 1; k <= K || K == -1 ; k++){
+		startDepth();
+		Stats::Phase depth(stats, "depth", k);
 
 		// lambda for generating unique variables.
 		Var newVarCounter = (k+2) * numVars + 10;
@@ -357,13 +770,10 @@ auto AIGtoSATer::mcmillanMC(int k) const -> Result
 			return ++newVarCounter;
 		};
 
-		firstR.setNewVar(newVar);
-		VecCNFer R(newVar); // R transformed
-		auto Rlit = firstR.copyAsTseitinExpression(R);
+		auto R = initR;
 
 		// compute B here, because it does not change in inner loop.
-		VecCNFer B;
-		B.setRecordUsedVariables(true);
+		VecCNFer B(newVar);
 		
 		for(auto i = 1; i != k; i++) {
 			T(B, vars, i);
@@ -373,128 +783,247 @@ auto AIGtoSATer::mcmillanMC(int k) const -> Result
 
 		for(auto i = 0;;i++){
 			std::cout << "ITERATION " << i << " WITH K=" << k << std::endl;
-			VecCNFer A;
-
+			Stats::Phase iteration(stats, "iteration", k, i);
+			VecCNFer A(newVar);
 
-			R.copyTo(A);
+			auto Rlit = circuit.toCNF(R, A);
 			A.addUnit(Rlit);
 			T(A, vars, 0);
+			C(A, vars, 1);
 
-			std::vector<Vertex> proof;
-			VecCNFer itp(newVar);
-
-			// lambda based proof traverser creates the refutation DAG in
-			// the `proof` vector from above.
-			auto partOfA = true;
-			auto proofTraverser = makeTraverser([&](const auto& c){ // root
-				Vertex vx(VertexRoot);
-				vx.c = c;
-				vx.partOfA = partOfA;
-
-				proof.push_back(std::move(vx));
-			}, [&](const auto& cs, const auto& xs){ // chain
-				Vertex vx(VertexChain);
-
-				assert(cs.size() == xs.size()+1);
-
-				vx.cs = cs;
-				vx.xs = xs;
-
-				proof.push_back(std::move(vx));
-			}, [&]{ /* done */ }, [&](ClauseId c){ // deleted
-				proof[c].c.clear();
-				proof[c].cs.clear();
-				proof[c].xs.clear();
-				proof[c].deleted = true;
-			});
-			auto s = newSolver(&proofTraverser);
+			RefutationSolver rs(offlineProofs, searchParams);
+			auto &s = rs.s;
 			SolverCNFer scnfer{*s};
 			vars.reset(&scnfer, numVars, k);
 			
 			A.copyTo(scnfer);
-			partOfA = false;
+			rs.endPartition();
 			B.copyTo(scnfer);
 
-#if 0
-			DimacsCNFer abd(std::cout);
-			vars.reset(&abd, numVars, k);
-			std::cout << "  <A>" << std::endl;
-			A.copyTo(abd);
-			std::cout << "  </A>" << std::endl;
-			std::cout << "  <B>" << std::endl;
-			B.copyTo(abd);
-			std::cout << "  </B>" << std::endl;
-#endif
-
-			if(s->solve({vars.True()})) { // SAT
+			applyBudget(*s);
+			const auto sat = s->solveLimited({vars.True()});
+			iteration.solver(*s);
+			iteration.set("result", satName(sat));
+			if(sat == l_Undef) {
+				std::cout << fixpointStats << std::endl;
+				return undecided(k, safe);
+			}
+			if(sat == l_True) { // SAT
 				std::cout << "A ^ B SAT" << std::endl;
-				if(i == 0)
+				if(i == 0) {
+					std::cout << fixpointStats << std::endl;
 					return FAIL;
+				}
 				else
 					break; // try again with k -> k+1
 			}
 
 			// UNSAT
+			if(i == 0) {
+				safe = k;
+			}
 
-			// compute interpolant ITP recursively. R2lit is the literal
-			// that is equisatisfiable to the interpolant.
-			auto R2lit = proof.back().assignLit(A, B, vars, proof.data(), itp);
+			// compute interpolant ITP recursively as a circuit.
+			Stats::Phase extraction(stats, "interpolant", k, i);
+			ItpPartitions parts;
+			parts.add(A, 0);
+			parts.add(B, 1);
+			auto itp = rs.interpolant(parts, 0, itpSystem, circuit);
 
 			// shift indices k = 1 -> k = 0 in ITP
-			for(auto& c : itp.raw()){
-				for(auto& lit : c) {
-					if (vars.timeIndex(lit) == 1) {
-						lit = vars.timeShift(lit, -1);
-					}
+			itp = circuit.remap(itp, [&](Lit lit) {
+				return vars.timeIndex(lit) == 1 ? vars.timeShift(lit, -1) : lit;
+			});
+
+			if (minimizeInterpolants) {
+				// merge equivalent nodes and drop the parts that R already
+				// covers. (R v ITP) stays the same.
+				const auto before = circuit.size(itp);
+				itp = circuit.sweep(itp);
+				itp = circuit.dropSubsumed(itp, R);
+				std::cout << "interpolant size " << before << " -> " << circuit.size(itp) << std::endl;
+				extraction.set("size_before", before);
+			}
+			extraction.set("size", circuit.size(itp));
+			extraction.done();
+
+			// check if R2 -> R. The cheap layers come first, only if they
+			// cannot decide, a Solver is used.
+			Stats::Phase fixpoint(stats, "fixpoint", k, i);
+			auto implied = cheapFixpointCheck(circuit, itp, R, fixpointStats);
+			if (implied == l_Undef) {
+				Solver rrs;
+				rrs.default_params = searchParams;
+				SolverCNFer rrscnfer(rrs);
+				vars.reset(&rrscnfer, numVars, k);
+
+				VecCNFer rr(newVar);
+				auto R2lit = circuit.toCNF(itp, rr);
+				Rlit = circuit.toCNF(R, rr);
+				rr.copyTo(rrscnfer);
+
+				// check if R2 -> R (<=> R = FALSE & R2 = TRUE is UNSAT)
+				rrscnfer.addUnit(~Rlit);
+				rrscnfer.addUnit(R2lit);
+
+				fixpointStats.sat++;
+				applyBudget(rrs);
+				implied = ~rrs.solveLimited({vars.True()});
+				fixpoint.solver(rrs);
+				if(implied == l_Undef) {
+					std::cout << fixpointStats << std::endl;
+					return undecided(k, safe);
 				}
 			}
 
-			// Solver that checks if R2 -> R.
-			Solver rrs;
-			SolverCNFer rrscnfer(rrs);
-			vars.reset(&rrscnfer, numVars, k);
+			fixpoint.set("implied", implied == l_True ? "yes" : implied == l_False ? "no" : "unknown");
+			fixpoint.done();
 
-			itp.copyTo(rrscnfer);
-			R.copyTo(rrscnfer);
-
-			// check if R2 -> R (<=> R = FALSE & R2 = TRUE is UNSAT)
-			rrscnfer.addUnit(~Rlit);
-			rrscnfer.addUnit(R2lit);
-
-#if 0
-			DimacsCNFer d(std::cout);
-			vars.reset(&d, numVars, k);
-			std::cout << "  <ITP>" << std::endl;
-			itp.copyTo(d);
-			std::cout << "  </ITP>" << std::endl;
-			std::cout << "  <R>" << std::endl;
-			R.copyTo(d);
-			std::cout << "  </R>" << std::endl;
-			std::cout << "  <check if R' -> R>" << std::endl;
-			d.addUnit(~Rlit);
-			d.addUnit(R2lit);
-			std::cout << "  </check if R' -> R>" << std::endl;
-#endif
-
-			if(!rrs.solve({vars.True()})) {
+			if(implied == l_True) {
 				std::cout << "R' -> R" << std::endl;
+				std::cout << fixpointStats << std::endl;
 				return OK;
 			}
 
-			auto newRlit = Lit(newVar(), false);
+			// (R v R2) becomes R
+			R = circuit.Or(R, itp);
+		}
+	}
+
+	std::cout << fixpointStats << std::endl;
+	std::cout << "undecided. increase k." << std::endl;
+
+	return FAIL;
+}
+
+auto AIGtoSATer::itpSeqMC(int k) const -> Result
+{
+	const auto K = k;
+	const auto numVars = aig.lastLit/2;
+
+	VarTranslator vars;
+	{
+		startDepth();
+		Stats::Phase depth(stats, "bmc", 0);
+		auto s = newSolver(nullptr, searchParams);
+		SolverCNFer scnfer{*s};
+		vars.reset(&scnfer, numVars, 0);
+
+		I(scnfer, vars);
+		F(scnfer, vars, 0, 0);
+
+		applyBudget(*s);
+		const auto sat = s->solveLimited({vars.True()});
+		depth.solver(*s);
+		depth.set("result", satName(sat));
+		if(sat == l_Undef) {
+			return undecided(0, -1);
+		}
+		if(sat == l_True) {
+			return FAIL;
+		}
+	}
+
+	VecCNFer init;
+	I(init, vars);
+
+	// Fs[j] over-approximates the states reachable in exactly j steps. All
+	// of them are circuits over the variables of time index 0.
+	Circuit circuit(vars.False());
+	std::vector<Lit> Fs{circuit.fromCNF(init.raw())};
+	FixpointStats fixpointStats;
+
+	for(k = 1; k <= K || K == -1 ; k++){
+		std::cout << "DEPTH " << k << std::endl;
+		startDepth();
+		Stats::Phase depth(stats, "depth", k);
+
+		// partition 0 is I ^ T(0), partition j is T(j) for 0 < j < k and
+		// partition k is the bad state at time index k. Shorter paths to a
+		// bad state were refuted at the previous depths.
+		std::vector<VecCNFer> P(k+1);
+		I(P[0], vars);
+		for(auto j = 0; j != k; j++) {
+			T(P[j], vars, j);
+			C(P[j], vars, j + 1);
+		}
+		F(P[k], vars, k, k);
+
+		ItpPartitions parts;
+		for(auto j = 0; j <= k; j++) {
+			parts.add(P[j], j);
+		}
+
+		RefutationSolver rs(offlineProofs, searchParams);
+		auto &s = rs.s;
+		SolverCNFer scnfer{*s};
+		vars.reset(&scnfer, numVars, k);
+
+		for(auto j = 0; j <= k; j++) {
+			P[j].copyTo(scnfer);
+			rs.endPartition();
+		}
+
+		applyBudget(*s);
+		const auto sat = s->solveLimited({vars.True()});
+		depth.solver(*s);
+		depth.set("result", satName(sat));
+		if(sat == l_Undef) {
+			return undecided(k, k-1);
+		}
+		if(sat == l_True) { // SAT
+			std::cout << "path to bad state of length " << k << std::endl;
+			return FAIL;
+		}
+
+		// extract the interpolant at every time index 1..k from the one
+		// refutation and conjoin it with the approximation of that frame.
+		// McMillan's system guarantees ITP(j) ^ T(j) -> ITP(j+1).
+		Stats::Phase extraction(stats, "interpolants", k);
+		Fs.push_back(circuit.True());
+		for(auto cut = 0; cut != k; cut++) {
+			const auto j = cut + 1;
+
+			auto itp = rs.interpolant(parts, cut, ItpSystem::McMillan, circuit);
 
-			// (R v R2) <-> newR
-			itp.copyTo(R);
+			itp = circuit.remap(itp, [&](Lit lit) {
+				assert(vars.timeIndex(lit) == j);
+				return vars.timeShift(lit, -j);
+			});
 
-			R.addBinary(~Rlit, newRlit);
-			R.addBinary(~R2lit, newRlit);
-			R.addTernary(~newRlit, Rlit, R2lit);
+			Fs[j] = circuit.And(Fs[j], itp);
+			if (minimizeInterpolants) {
+				Fs[j] = circuit.sweep(Fs[j]);
+			}
+		}
 
-			// newR becomes R
-			Rlit = newRlit;
+		extraction.set("size", circuit.size(Fs[k]));
+		extraction.done();
+
+		// fixpoint: F(j) -> F(0) v ... v F(j-1). As in mcmillanMC, the
+		// cheap layers come first and the Solver gets the depth's budget.
+		Stats::Phase fixpoint(stats, "fixpoint", k);
+		auto reached = Fs[0];
+		for(auto j = 1; j <= k; j++) {
+			auto implied = cheapFixpointCheck(circuit, Fs[j], reached, fixpointStats);
+			if (implied == l_Undef) {
+				fixpointStats.sat++;
+				implied = circuit.implies(Fs[j], reached, [&](Solver &s) { applyBudget(s); });
+				if (implied == l_Undef) {
+					std::cout << fixpointStats << std::endl;
+					return undecided(k, k);
+				}
+			}
+			if(implied == l_True) {
+				std::cout << "F" << j << " -> F0 v ... v F" << (j-1) << std::endl;
+				std::cout << fixpointStats << std::endl;
+				return OK;
+			}
+			reached = circuit.Or(reached, Fs[j]);
 		}
 	}
 
+	std::cout << fixpointStats << std::endl;
 	std::cout << "undecided. increase k." << std::endl;
 
 	return FAIL;
@@ -502,24 +1031,160 @@ auto AIGtoSATer::mcmillanMC(int k) const -> Result
 
 auto AIGtoSATer::classicMC(int k) const -> Result
 {
-	auto s = newSolver(nullptr);
-	SolverCNFer scnfer{*s};
+	if (abstraction) {
+		return abstractMC(k);
+	}
+
+	if (direction != BmcDirection::Forward) {
+		return backwardMC(k);
+	}
+
+	if (exactDepth) {
+		return exactMC(k);
+	}
+
+	if (learntTransfer) {
+		return transferMC(k);
+	}
+
+	startDepth();
+	Stats::Phase bmc(stats, "bmc", k);
+
+	if (cubeDepth > 0) {
+		VecCNFer cnf;
+		VarTranslator vars{&cnf, aig.lastLit/2, k};
+		if (latchAliasing)
+			vars.aliasLatches(aig.latches);
+		toSAT(cnf, vars, k);
+		cnf.addUnit(vars.True());
+
+		// the inputs and latches of the middle frame split the paths in
+		// two halves of the same length.
+		std::vector<Var> candidates;
+		for (const auto input : aig.inputs) {
+			candidates.push_back(var(vars.toLit(input, k/2)));
+		}
+		for (const auto &latch : aig.latches) {
+			candidates.push_back(var(vars.toLit(latch.first, k/2)));
+		}
+
+		CubeAndConquer cc(parallelWorkers, cubeDepth, searchParams);
+		cc.setVariableElimination(variableElimination);
+		const auto sat = cc.solve(cnf, candidates, [&](Solver &s) { applyBudget(s); });
+
+		const auto &cubes = cc.solvedCubes();
+		for (size_t i = 0; i != cubes.size(); i++) {
+			const auto &cube = cubes[i];
+			std::cout << "cube " << i << " (" << cube.lits.size() << " literals): ";
+			if (cube.worker == -1) {
+				std::cout << "not started" << std::endl;
+				continue;
+			}
+			std::cout << (cube.result == l_True ? "SAT" : cube.result == l_False ? "UNSAT" : "undecided")
+			          << " by solver " << cube.worker << ", " << cube.conflicts << " conflicts, "
+			          << cube.seconds << " s" << std::endl;
+
+			Stats::Phase phase(stats, "cube", k, i);
+			phase.set("literals", int(cube.lits.size()));
+			phase.set("worker", cube.worker);
+			phase.set("conflicts", cube.conflicts);
+			phase.set("decisions", cube.decisions);
+			phase.set("result", satName(cube.result));
+			phase.done(cube.seconds);
+		}
+		std::cout << cubes.size() << " cubes, " << cc.refutedCubes() << " refuted by lookahead" << std::endl;
+
+		bmc.set("cubes", int(cubes.size()));
+		bmc.set("refuted_cubes", cc.refutedCubes());
+		bmc.set("result", satName(sat));
+		if (sat == l_Undef) {
+			return undecided(k, -1);
+		}
+		return sat == l_True ? FAIL : OK;
+	}
+
+	if (parallelWorkers > 1) {
+		// without assumptions, so that the workers can import clauses at
+		// decision level 0.
+		VecCNFer cnf;
+		VarTranslator vars{&cnf, aig.lastLit/2, k};
+		if (latchAliasing)
+			vars.aliasLatches(aig.latches);
+		toSAT(cnf, vars, k);
+		cnf.addUnit(vars.True());
+
+		Portfolio portfolio(parallelWorkers, searchParams);
+		portfolio.setVariableElimination(variableElimination);
+		const auto sat = portfolio.solve(cnf, [&](Solver &s) { applyBudget(s); });
+		std::cout << "portfolio of " << parallelWorkers << " solvers, decided by solver "
+		          << portfolio.winner() << ", " << portfolio.importedClauses()
+		          << " clauses imported" << std::endl;
+		bmc.set("workers", parallelWorkers);
+		bmc.set("imported", portfolio.importedClauses());
+		bmc.set("result", satName(sat));
+		if (sat == l_Undef) {
+			return undecided(k, -1);
+		}
+		return sat == l_True ? FAIL : OK;
+	}
+
+	SimpSolver s;
+	s.default_params = searchParams;
+	SolverCNFer scnfer{s};
 	VarTranslator vars{&scnfer, aig.lastLit/2, k};
+	if (latchAliasing)
+		vars.aliasLatches(aig.latches);
 
 	toSAT(scnfer, vars, k);
 
+	// The formula is solved once, so only the assumption True() has to be
+	// kept. The model is extended to the eliminated variables.
+	if (variableElimination) {
+		Stats::Phase preprocess(stats, "preprocess", k);
+		const auto clauses = s.nClauses();
+		s.setFrozen(var(vars.True()), true);
+		s.eliminate();
+		preprocess.set("vars", s.nVars());
+		preprocess.set("eliminated_vars", s.eliminated_vars);
+		preprocess.set("clauses_before", clauses);
+		preprocess.set("clauses_after", s.nClauses());
+		std::cout << "variable elimination removed " << s.eliminated_vars << " of "
+		          << s.nVars() << " variables, " << clauses << " -> " << s.nClauses()
+		          << " clauses" << std::endl;
+	} else {
+		s.use_elim = false;
+	}
+
 	// true =>  SAT
 	// false => UNSAT
 	// SAT => E  a path to a Bad State.
-	return s->solve({vars.True()}) ? FAIL : OK;
+	applyBudget(s);
+	const auto sat = s.solveLimited({vars.True()});
+	bmc.solver(s);
+	bmc.set("result", satName(sat));
+	if (sat == l_Undef) {
+		return undecided(k, -1);
+	}
+	return sat == l_True ? FAIL : OK;
 }
 
-
 auto AIGtoSATer::check(int k) const -> Result
 {
+	if(aig.Properties().size() > 1){
+		return multiPropertyMC(k);
+	}
+
+	if(interpolationSequence){
+		return itpSeqMC(k);
+	}
+
 	if(interpolation){
 		return mcmillanMC(k);
 	}
 
+	if(depthScheduling){
+		return scheduledMC(k);
+	}
+
 	return classicMC(k);
 }
\ No newline at end of file
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 #include "MiniSat-p_v1.14/Solver.h"
 #include "aag.h"
 #include "cnfer.h"
+#include "interpolant.h"
+#include "scheduler.h"
+#include "stats.h"
 
 struct TranslationError : public std::runtime_error {
 	explicit TranslationError(const char *s);
@@ -22,6 +32,7 @@ class VarTranslator {
 	int first, last;
 	int numVars;
 	std::map<std::pair<int,int>, int> m;
+	std::vector<int> next; // next[v] is the next-state literal of latch v, or -1
 
 public:
 	explicit VarTranslator();
@@ -45,66 +56,385 @@ public:
 	// add it to the assumptions of a solver.
 	auto True() const -> Lit;
 
-	// timeIndex returns the time index of a literal.
+	// aliasLatches makes toLit map the output of a latch at step n+1 to the
+	// literal of its next-state function at step n, so that no variables and
+	// no equivalence clauses are needed for latches after step 0.
+	void aliasLatches(const std::vector<std::pair<int, int>> &latches);
+
+	// latchesAliased returns whether aliasLatches was called.
+	auto latchesAliased() const -> bool;
+
+	// varsPerStep returns the number of variables reserved for every step.
+	auto varsPerStep() const -> int;
+
+	// timeIndex returns the time index of a literal. With aliased latches, the
+	// state at a step is no longer a set of variables of that step, so time
+	// indices are only defined without aliases.
 	auto timeIndex(Lit lit) const -> int;
 
-	// timeShift shifts the literals time index.
+	// timeShift shifts the literals time index. The constants are not
+	// shifted. Like timeIndex, it is only defined without aliases.
 	auto timeShift(Lit lit, int shift) const -> Lit;
 };
 
+// parseRestartPolicy converts "geometric", "luby" or "glucose" to a
+// RestartPolicy. It throws std::invalid_argument for other names.
+auto parseRestartPolicy(const std::string &name) -> RestartPolicy;
+
+// BmcDirection selects how the depth-by-depth BMC engines unroll the model:
+// forward from the initial states, backward from the bad states, or from
+// both ends at once.
+enum class BmcDirection { Forward, Backward, Bidirectional };
+
+// parseBmcDirection converts "forward", "backward" or "both" to a
+// BmcDirection. It throws std::invalid_argument for other names.
+auto parseBmcDirection(const std::string &name) -> BmcDirection;
+
+// FrameTemplate holds the clauses of the transition step T(0) in a flat
+// buffer. The clauses of T(step) are the same with every variable moved by
+// step frames, except for the constants, so they are instantiated by adding
+// an offset instead of being encoded gate by gate again.
+class FrameTemplate {
+	std::vector<int> lits;  // index() of the literals
+	std::vector<int> moves; // 1 for literals that move with the frame, 0 for constants
+	vec<int> sizes;
+	int varsPerStep;
+
+public:
+	// step0 holds the clauses of T(0) translated by vars.
+	FrameTemplate(const VecCNFer &step0, const VarTranslator &vars);
+
+	// fits returns whether the template can be used with vars.
+	auto fits(const VarTranslator &vars) const -> bool;
+
+	// instantiate adds the clauses of T(step) to s in one bulk load. It may
+	// be called from several threads at once.
+	void instantiate(CNFer &s, int step) const;
+};
+
+// EnlargedTarget is a model whose bad states were extended by the states
+// that reach one in up to `steps` steps (see AIGtoSATer::enlargeTarget).
+struct EnlargedTarget {
+	AIG aig;
+	int steps = 0;
+	int cubes = 0; // of the preimages
+};
+
 extern TranslationError ErrNegatedOutput;
 extern TranslationError ErrOutputNotSingular;
 
+// DepthCheck is the check of one BMC depth by an engine that goes depth by
+// depth (see AIGtoSATer::depthByDepth).
+struct DepthCheck {
+	Stats::Phase phase; // "depth" in the statistics
+	int64_t conflicts = 0; // of all SAT calls of the depth
+	std::ostringstream report; // more details for the line of the depth
+
+	DepthCheck(Stats *stats, int d) : phase(stats, "depth", d) {}
+};
+
 // AIGtoSATer is the actual model checker.
 class AIGtoSATer {
 public:
-	enum Result { _, OK, FAIL };
+	enum Result { _, OK, FAIL, UNDECIDED };
 
 private:
 	const AIG &aig;
 	bool interpolation = false;
+	bool interpolationSequence = false;
+	bool minimizeInterpolants = true;
+	ItpSystem itpSystem = ItpSystem::McMillan;
+	bool offlineProofs = false;
+	SearchParams searchParams;
+	bool variableElimination = true;
+	int parallelWorkers = 1;
+	int cubeDepth = 0;
+	bool latchAliasing = false;
+	bool depthScheduling = false;
+	bool learntTransfer = false;
+	bool exactDepth = false;
+	BmcDirection direction = BmcDirection::Forward;
+	bool abstraction = false;
+	int depthOffset = 0;
+	DepthScheduler::Order depthOrder = DepthScheduler::Interleaved;
+	int64_t conflictLimit = -1;
+	double depthTimeLimit = -1;
+	mutable std::chrono::steady_clock::time_point depthDeadline;
+	mutable std::atomic<bool> interrupted{false};
+	Stats *stats = nullptr;
+	mutable std::shared_ptr<const FrameTemplate> frameTemplate;
+	mutable std::mutex frameTemplateLock;
+
+	// undecided reports that a limit was reached at depth k, when all paths of
+	// length up to safe (-1 if none) were found to be free of bad states.
+	auto undecided(int k, int safe) const -> Result;
+
+	// reportShortest reports depth as the length of a shortest counterexample.
+	void reportShortest(int depth) const;
+
+	// depthDeadlineFromNow returns when a depth that starts now runs out of
+	// time.
+	auto depthDeadlineFromNow() const -> std::chrono::steady_clock::time_point;
+
+	// startDepth starts the time limit of a new BMC depth.
+	void startDepth() const;
+
+	// applyBudget sets the conflict limit and the time left for the current
+	// depth as the budget of the next solveLimited() call of s, and makes
+	// interrupt() stop s.
+	void applyBudget(Solver &s) const;
+
+	// applyBudget does the same for a depth that ends at deadline, e.g. one
+	// of several depths that are checked concurrently.
+	void applyBudget(Solver &s, std::chrono::steady_clock::time_point deadline) const;
+
+	// depthByDepth calls check for the depths 0..k, each one with its own
+	// time limit, and reports every depth as "depth d: <result>, <conflicts>
+	// conflicts" followed by the report of the check. check returns l_False
+	// if the depth is free of bad states. At l_True, the depth is reported
+	// as a shortest counterexample and FAIL returned, at l_Undef UNDECIDED.
+	auto depthByDepth(int k, const std::function<lbool(int d, DepthCheck &depth)> &check) const -> Result;
+
+	// solveDepth solves s under assumps with the budget of the current depth
+	// and adds the conflicts and the solver statistics to depth.
+	auto solveDepth(Solver &s, const vec<Lit> &assumps, DepthCheck &depth) const -> lbool;
+
+	// encodeT adds the clauses of T(step) gate by gate and latch by latch. T
+	// uses it to build its FrameTemplate.
+	void encodeT(CNFer& s, VarTranslator& vars, int step) const;
+
+	// latchSteps adds the latch transitions q(step+1) <-> d(step) of T(step).
+	void latchSteps(CNFer& s, VarTranslator& vars, int step) const;
 
 	// andgates adds the clauses representing the AND gates of the
 	// AIGER model to the given CNFer. The VarTranslator is used to
 	// translate AIGER literals to CNFer/Solver literals. The step is
 	// the time index (starting at 0). 
 	void andgates(CNFer& s, VarTranslator& vars, int step) const;
+
+	// C adds the invariant constraints of step as unit clauses. A path only
+	// has to meet them up to its bad state, so C is only used for steps
+	// that are not beyond any bad state a check asks for.
+	void C(CNFer& s, VarTranslator& vars, int step) const;
+
+	// constrained returns a new literal that implies ok and the invariant
+	// constraints of step, or ok itself if there are no constraints. A chain
+	// of them gives every step a literal for "the constraints hold so far".
+	auto constrained(CNFer& s, VarTranslator& vars, Lit ok, int step) const -> Lit;
+
+	// resetLit returns the literal saying that latch l (an index into
+	// aig.latches) has its reset value at step, or lit_Undef if the latch
+	// is uninitialized.
+	auto resetLit(VarTranslator& vars, size_t l, int step) const -> Lit;
 	
 	// mcmillanMC performs unbounded model checking based on the McMillan paper
 	// up to a bound k. To disable the bound, set k == -1.
 	auto mcmillanMC(int k) const -> Result;
 
+	// itpSeqMC performs unbounded model checking with interpolation sequences
+	// (Vizel and Grumberg): every BMC depth is refuted once, and the whole
+	// sequence of interpolants of that refutation refines per-frame
+	// approximations of the reachable states. To disable the bound, set k == -1.
+	auto itpSeqMC(int k) const -> Result;
+
 	// classicMC performs bounded model checking with bound k.
 	auto classicMC(int k) const -> Result;
 
+	// exactMC performs bounded model checking depth by depth up to k on one
+	// incremental solver, checking the bad states at exactly the current
+	// depth (see setExactDepth).
+	auto exactMC(int k) const -> Result;
+
+	// abstractMC performs bounded model checking depth by depth up to k on
+	// an abstraction of the latches (see setAbstraction).
+	auto abstractMC(int k) const -> Result;
+
+	// backwardMC performs bounded model checking depth by depth up to k,
+	// unrolling backward from the bad states (see setDirection).
+	auto backwardMC(int k) const -> Result;
+
+	// transferMC performs bounded model checking depth by depth up to k with
+	// a fresh solver for every depth, which starts with the short learnt
+	// clauses of the previous one (see setLearntTransfer).
+	auto transferMC(int k) const -> Result;
+
+	// multiPropertyMC performs bounded model checking depth by depth up to k
+	// for all outputs and bad state properties at once, on one incremental
+	// solver. Every property is checked at the current depth under its own
+	// assumption literal. A property is retired when it fails, when a limit
+	// is reached, or when its bad state was refuted without the initial
+	// state, i.e. cannot be reached from any state in that many steps. It
+	// prints a table of the results and returns FAIL if any property fails.
+	auto multiPropertyMC(int k) const -> Result;
+
+	// scheduledMC performs bounded model checking with bound k by checking
+	// the depths separately on incremental solvers in parallel threads.
+	auto scheduledMC(int k) const -> Result;
+
 public:
 
 	// Construct the model checker based on a parsed AIGER representation.
 	AIGtoSATer(const AIG &aig);
 
-	// I adds the initial state (and gate outputs at k=0 and zero initialized
-	// latch outputs) to the given CNFer.
-	void I(CNFer& s, VarTranslator& vars) const;
+	// I adds the initial state (and gate outputs at k=0, the latch outputs
+	// at their reset values and the invariant constraints of k=0) to the
+	// given CNFer. Unless act is lit_Undef, the reset values are only
+	// required under act. Uninitialized latches are left free.
+	void I(CNFer& s, VarTranslator& vars, Lit act = lit_Undef) const;
 
 	// T adds a transition function (step is the time index) to the CNFer.
+	// Unless latches are aliased, the clauses are instantiated from a
+	// template of the first step. T may be called from several threads at
+	// once with different CNFers.
 	void T(CNFer& s, VarTranslator& vars, int step) const;
 
 	// F adds the final condition (the bad state detector from the AIGER
 	// model) to the CNFer. It adds the variable with all time indices
-	// starting at `from` up to and including `to`.
-	void F(CNFer& s, VarTranslator& vars, int from, int to) const;
+	// starting at `from` up to and including `to`. The bad state at a time
+	// index only counts if the invariant constraints hold at the indices
+	// after `from` up to it; the ones up to `from` are left to the caller.
+	// Unless act is lit_Undef, the condition is only required under act.
+	void F(CNFer& s, VarTranslator& vars, int from, int to, Lit act = lit_Undef) const;
 
 	// toSAT translates the AIGER model into a bounded model checking CNF, whose
 	// clauses are added to the given CNFer. This is used internally in classicMC,
 	// but it can also used together with a DimacsCNFer to view the generated formula.
 	void toSAT(CNFer& s, VarTranslator& vars, int k) const;
 
+	// enlargeTarget computes the states that reach a bad state in 1..steps
+	// steps (for some inputs) as cubes over the latches, and returns a copy of
+	// the model whose output is the disjunction of the bad states and these
+	// cubes. The cubes of every preimage are enumerated by SAT calls of at
+	// most maxConflicts conflicts and generalized by the final conflict of a
+	// simulation of the preimage with the inputs found, and then by ternary
+	// simulation with one latch after the other unknown. The enlargement
+	// stops early at a preimage of maxCubes or more cubes or when a SAT call
+	// runs out of conflicts.
+	auto enlargeTarget(int steps, int maxCubes = 32, int64_t maxConflicts = 10000) const -> EnlargedTarget;
+
 	// enableInterpolation enables interpolation mode in the AIGtoSATer.
 	// It cannot be disabled after that.
 	void enableInterpolation();
 
+	// enableInterpolationSequence enables the interpolation sequence engine
+	// instead of McMillan's. It cannot be disabled after that.
+	void enableInterpolationSequence();
+
+	// setInterpolantMinimization turns the simplification of interpolants
+	// (SAT sweeping and removal of parts already covered by R) on or off.
+	// It is turned on by default.
+	void setInterpolantMinimization(bool yes);
+
+	// setInterpolationSystem selects the labeled interpolation system used to
+	// compute interpolants. McMillan's system is the default.
+	void setInterpolationSystem(ItpSystem system);
+
+	// enableOfflineProofs makes the interpolation engines log proofs to
+	// temporary files instead of keeping them in memory. Before interpolants
+	// are computed, a proof is compressed to the clauses the refutation
+	// depends on. It cannot be disabled after that.
+	void enableOfflineProofs();
+
+	// setRestartPolicy selects the restart strategy of the solvers that
+	// check the model. Glucose-style restarts are the default.
+	void setRestartPolicy(RestartPolicy policy);
+
+	// setPhaseSaving turns phase saving in the solvers that check the model
+	// on or off. It is turned on by default.
+	void setPhaseSaving(bool yes);
+
+	// setVariableElimination turns the preprocessing of the BMC formula by
+	// variable elimination and subsumption on or off. It is turned on by
+	// default and only used by the classical BMC check.
+	void setVariableElimination(bool yes);
+
+	// setLatchAliasing turns the aliasing of latch outputs to their next-state
+	// functions (see VarTranslator::aliasLatches) in the classical BMC check
+	// on or off. The interpolation engines need latch variables in every
+	// frame and ignore it. It is turned off by default.
+	void setLatchAliasing(bool yes);
+
+	// setParallelWorkers makes the classical BMC check solve its formula with
+	// a portfolio of n diversified solvers in parallel threads, which share
+	// learnt clauses. The interpolation engines need proofs and always use a
+	// single solver. The default is 1 (no portfolio).
+	void setParallelWorkers(int n);
+
+	// setCubeDepth makes the classical BMC check split its formula into cubes
+	// of depth variables (inputs and latches of the middle frame, chosen by
+	// lookahead), which are solved by the parallel workers. 0 (the default)
+	// turns cube-and-conquer off.
+	void setCubeDepth(int depth);
+
+	// setDepthScheduling makes the classical BMC check the depths 0..k one
+	// range at a time instead of all at once, on as many incremental solvers
+	// in parallel threads as there are workers (see setParallelWorkers). It
+	// reports the smallest depth with a counterexample. It is turned off by
+	// default.
+	void setDepthScheduling(DepthScheduler::Order order);
+
+	// setExactDepth makes the classical BMC check the depths 0..k one after
+	// the other on one incremental solver. Depth d only asks for a bad state
+	// at step d: the bad states of the shallower depths were refuted already
+	// and are excluded by unit clauses. The first counterexample found is
+	// thus a shortest one. It is turned off by default.
+	void setExactDepth(bool yes);
+
+	// setDepthOffset adds steps to the depths of the reports, for a model
+	// whose target was enlarged by that many steps.
+	void setDepthOffset(int steps);
+
+	// setAbstraction makes the classical BMC check the depths 0..k one after
+	// the other on one incremental solver like setExactDepth, but on an
+	// abstract model in which the latches that are not visible are cut into
+	// free inputs. A counterexample of the abstract model is simulated on
+	// the concrete one; if it is spurious, the latches in the final conflict
+	// of the simulation become visible. Once a depth is refuted, only the
+	// latches its refutation used stay visible (proof-based abstraction).
+	// It is turned off by default.
+	void setAbstraction(bool yes);
+
+	// setDirection makes the classical BMC check the depths 0..k one after
+	// the other on one incremental solver like setExactDepth, but unrolled
+	// backward from a bad state until an initial state is reached, or from
+	// both ends until they meet. The backward steps use mirrored time
+	// indices: the bad state is at step k, its predecessors at k-1, k-2, ...
+	// Latches are not aliased then. Forward (the default) turns it off.
+	void setDirection(BmcDirection direction);
+
+	// setLearntTransfer makes the classical BMC check the depths 0..k one
+	// after the other, each with a fresh solver that imports the short learnt
+	// clauses of the previous depth. Clauses derived from the bad states are
+	// dropped, the ones derived from the transition steps alone are also
+	// imported shifted by one frame. Latches are not aliased then. It is
+	// turned off by default.
+	void setLearntTransfer(bool yes);
+
+	// setConflictLimit limits the number of conflicts of every SAT call of
+	// the model checker. -1 (the default) means no limit.
+	void setConflictLimit(int64_t conflicts);
+
+	// setDepthTimeLimit limits the wall-clock time spent on every BMC depth:
+	// SAT calls give up once the depth has taken that long (other work, like
+	// simplifying interpolants, is not interrupted). -1 (the default) means no
+	// limit.
+	void setDepthTimeLimit(double seconds);
+
+	// setStats makes the model checker record its phases (preprocessing, BMC
+	// depths, interpolation iterations, ...) in stats. nullptr (the default)
+	// turns the recording off.
+	void setStats(Stats *stats);
+
+	// interrupt stops a running check as soon as possible. It may be called
+	// from another thread or a signal handler.
+	void interrupt();
+
 	// check runs the model checker with a bound k. When interpolation is turned on,
-	// k can be -1 in which case there is no upper bound. 
+	// k can be -1 in which case there is no upper bound. If a limit is reached or
+	// the check is interrupted, UNDECIDED is returned and the depth up to which
+	// there is no counterexample is reported. A model with several properties
+	// (see AIG::Properties) is checked by bounded model checking of all of them
+	// at once; the interpolation engines only support one.
 	auto check(int k) const -> Result;
 };
 
@@ -0,0 +1,45 @@
+#include "workers.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void runWorkers(int n, const std::function<void(int worker)> &work, const std::atomic<bool> &interrupt,
+                const std::function<void()> &onInterrupt)
+{
+	std::mutex m;
+	std::condition_variable finished;
+	auto running = n;
+
+	std::vector<std::thread> threads;
+	for (auto i = 0; i != n; i++) {
+		threads.emplace_back([&, i] {
+			work(i);
+
+			std::lock_guard<std::mutex> lock(m);
+			running--;
+			finished.notify_one();
+		});
+	}
+
+	{
+		// pass an interrupt on to the workers. onInterrupt may have to wait
+		// for a worker, so m is not held while it runs.
+		auto interrupted = false;
+		std::unique_lock<std::mutex> lock(m);
+		while (running != 0) {
+			finished.wait_for(lock, std::chrono::milliseconds(10));
+			if (!interrupted && interrupt.load()) {
+				interrupted = true;
+				lock.unlock();
+				onInterrupt();
+				lock.lock();
+			}
+		}
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+// runWorkers runs work(i) for the workers i = 0..n-1 in threads of their own
+// and returns when all of them have returned. While they run, interrupt is
+// polled every 10 ms, and once it is set, onInterrupt is called to stop the
+// workers. onInterrupt is called at most once, from the calling thread.
+void runWorkers(int n, const std::function<void(int worker)> &work, const std::atomic<bool> &interrupt,
+                const std::function<void()> &onInterrupt);